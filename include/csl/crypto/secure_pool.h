@@ -0,0 +1,231 @@
+///
+/// \file       secure_pool.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Separate memory pool for key material
+///
+
+#pragma once
+
+#include <base/env.h>
+#include <base/allocator.h>
+#include <base/lock.h>
+
+#include <csl/util/stdint.h>
+#include <csl/util/string.h>
+#include <csl/util/exception.h>
+#include <csl/util/fthrow.h>
+
+namespace Csl
+{
+	///
+	/// Overwrite size bytes at p with zeroes. Unlike a plain memset, the
+	/// compiler can't leave this out when p isn't read afterwards.
+	///
+	void secure_wipe( void *p, size_t size );
+
+	///
+	/// Allocator for secrets, on RAM dataspaces of its own.
+	///
+	/// Secrets don't end up scattered over the general heap: they stay
+	/// in the dataspaces of the pool, blocks are wiped when they are
+	/// freed, and wipe() clears the whole pool on shutdown. Blocks come
+	/// from power-of-two size classes, and the pool keeps no metadata
+	/// in its dataspaces besides the links of free blocks.
+	///
+	/// Use it through Secure_byte_array and Secure_string, or pass it
+	/// to the APIs that take a Genode::Allocator.
+	///
+	class Secure_pool: public Genode::Allocator
+	{
+		public:
+			static const size_t MIN_BLOCK = 16;
+			static const unsigned CLASSES = 13;           // up to 64 KB
+			static const size_t CHUNK_SIZE = 256 * 1024;
+			static const unsigned MAX_CHUNKS = 16;
+
+		private:
+			struct Free_block
+			{
+				Free_block *next;
+			};
+
+			struct Chunk
+			{
+				Genode::Ram_dataspace_capability ds;
+				char *base;
+				size_t size;
+			};
+
+			Genode::Ram_session &_ram;
+			Genode::Region_map &_rm;
+			Genode::Lock _lock;
+			Chunk _chunks[MAX_CHUNKS];
+			unsigned _chunk_count;
+			unsigned _chunks_used;      // chunks carved from since the last wipe()
+			char *_top;
+			char *_end;
+			Free_block *_free[CLASSES];
+			size_t _consumed;
+
+			Secure_pool( const Secure_pool & );
+			Secure_pool &operator=( const Secure_pool & );
+
+			static unsigned _class_of( size_t size );
+
+			bool _grow( size_t size );
+
+		public:
+			Secure_pool( Genode::Env &env );
+
+			/// Wipes and releases the dataspaces.
+			~Secure_pool();
+
+			static size_t class_size( const unsigned c )
+			{
+				return MIN_BLOCK << c;
+			}
+
+			bool alloc( size_t size, void **out_addr ) override;
+
+			/// Wipe and free block p of size bytes.
+			void free( void *p, size_t size ) override;
+
+			/// Wipe the whole pool. All blocks become invalid, call it
+			/// on shutdown after the last secret is destroyed, or when
+			/// the secrets must go regardless.
+			void wipe();
+
+			size_t consumed() const override
+			{
+				return _consumed;
+			}
+
+			size_t overhead( size_t ) const override
+			{
+				return 0;
+			}
+
+			bool need_size_for_free() const override
+			{
+				return true;
+			}
+
+			/// \return the pool of the component.
+			///
+			/// \throw Exception when init_secure_pool() wasn't called.
+			///
+			static Secure_pool &instance();
+	};
+
+	///
+	/// Create the pool returned by Secure_pool::instance(). Call it in
+	/// Component::construct(), before secrets are created.
+	///
+	void init_secure_pool( Genode::Env &env );
+
+	///
+	/// Fixed-size array for secrets, in the Secure_pool. Use it instead
+	/// of Byte_array for keys, nonces and passwords.
+	///
+	template<size_t MAX_SIZE = 1024, typename C = char>
+	class Secure_byte_array
+	{
+		public:
+			static const size_t SIZE = MAX_SIZE;
+
+			C *const val;
+
+		private:
+			static C *_allocate()
+			{
+				void *p = nullptr;
+
+				if ( not Secure_pool::instance().alloc( MAX_SIZE * sizeof( C ), &p ) )
+				{
+					throw Genode::Allocator::Out_of_memory();
+				}
+
+				return static_cast<C *>( p );
+			}
+
+		public:
+			void nullify()
+			{
+				secure_wipe( val, MAX_SIZE * sizeof( C ) );
+			}
+
+			size_t capacity() const
+			{
+				// last array_element is saved for the 0 value.
+				return MAX_SIZE - 1;
+			}
+
+			Secure_byte_array(): val( _allocate() )
+			{
+				nullify();
+			}
+
+			Secure_byte_array( const Secure_byte_array &other ): Secure_byte_array()
+			{
+				Genode::memcpy( val, other.val, MAX_SIZE * sizeof( C ) );
+			}
+
+			Secure_byte_array( const Csl::Basic_string<C> &s ): Secure_byte_array()
+			{
+				if ( capacity() < s.length() )
+				{
+					fthrow<Exception>( "Insufficient space to store %i bytes", s.length() );
+				}
+
+				Genode::memcpy( val, s.data(), s.length() * sizeof( C ) );
+			}
+
+			Secure_byte_array &operator=( const Secure_byte_array &other )
+			{
+				if ( this != &other )
+				{
+					Genode::memcpy( val, other.val, MAX_SIZE * sizeof( C ) );
+				}
+
+				return *this;
+			}
+
+			~Secure_byte_array()
+			{
+				// the pool wipes the block
+				Secure_pool::instance().free( val, MAX_SIZE * sizeof( C ) );
+			}
+	};
+
+	///
+	/// String for secrets, its characters are kept in the Secure_pool.
+	/// Copies are Secure_strings too, but the strings returned by the
+	/// operations of Basic_string (substr(), operator+, ...) are
+	/// ordinary strings: don't use them for secrets.
+	///
+	class Secure_string: public Basic_string<char>
+	{
+		public:
+			Secure_string(): Basic_string<char>( Secure_pool::instance() ) {}
+
+			Secure_string( const char *s ): Basic_string<char>( s, Secure_pool::instance() ) {}
+
+			Secure_string( const Secure_string &other ): Secure_string()
+			{
+				Basic_string<char>::operator=( other );
+			}
+
+			Secure_string &operator=( const Secure_string &other )
+			{
+				Basic_string<char>::operator=( other );
+				return *this;
+			}
+	};
+} // namespace Csl
@@ -0,0 +1,438 @@
+///
+/// \file       alloc.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Size-class slab allocator behind the global operator new
+///
+
+#pragma once
+
+#include <base/env.h>
+#include <base/allocator.h>
+#include <base/lock.h>
+
+#include <csl/util/stdint.h>
+#include <csl/util/cache.h>
+
+namespace Csl
+{
+	///
+	/// Allocator for large blocks, each in a RAM dataspace of its own.
+	///
+	/// Large blocks don't fragment the heap, and their memory goes back
+	/// to the RAM session when they are freed. Recently freed
+	/// dataspaces are cached, up to CACHE_ENTRIES and CACHE_BYTES, and
+	/// reused for blocks of about the same size, so packet rings and
+	/// buffers that are reallocated often don't pay for a dataspace
+	/// allocation each time.
+	///
+	/// Blocks are preceded by a small header in the same dataspace.
+	/// dataspace() returns the dataspace of a block, so it can be shared
+	/// with other components without copying.
+	///
+	class Large_allocator
+	{
+		public:
+			/// Blocks from this size on are taken from dataspaces by the
+			/// global operator new
+			static const size_t THRESHOLD = 64 * 1024;
+
+			static const unsigned CACHE_ENTRIES = 8;
+			static const size_t CACHE_BYTES = 4 * 1024 * 1024;
+
+		private:
+			/// Start of every dataspace
+			struct alignas( 16 ) Block
+			{
+				Genode::Ram_dataspace_capability ds;
+				size_t size;         // of the dataspace
+				Block *next;         // in the cache
+			};
+
+			Genode::Ram_session &_ram;
+			Genode::Region_map &_rm;
+			Genode::Lock _lock;
+			Block *_cache;
+			unsigned _cached;
+			size_t _cached_bytes;
+
+			Large_allocator( const Large_allocator & );
+			Large_allocator &operator=( const Large_allocator & );
+
+			Block *_from_cache( size_t size );
+			void _release( Block *block );
+
+		public:
+			Large_allocator( Genode::Env &env );
+
+			/// Releases the cached dataspaces, blocks in use are left.
+			~Large_allocator();
+
+			/// \return block of at least size bytes, aligned at 16 bytes,
+			///         or nullptr when the RAM quota is exhausted.
+			void *alloc( size_t size );
+
+			void free( void *p );
+
+			/// Release the cached dataspaces.
+			void flush();
+
+			/// \return the dataspace that holds block p
+			///
+			/// \param offset  receives the offset of p in the dataspace
+			///
+			static Genode::Ram_dataspace_capability dataspace( const void *p, size_t &offset );
+	};
+
+	///
+	/// Allocator behind the global operator new and delete.
+	///
+	/// Small blocks come from size classes, carved out of CHUNK_SIZE
+	/// chunks of the backing heap. Freed blocks are kept per class in
+	/// per thread caches, and move between the caches and a central
+	/// free list in batches, so most allocations take an uncontended
+	/// lock and pop a list. Larger blocks go to the backing heap, and
+	/// blocks of Large_allocator::THRESHOLD bytes and more to their own
+	/// dataspace, once init_allocator() was called.
+	///
+	/// Every block is preceded by a header that records its class, so
+	/// an unsized delete finds the class without a lookup. A sized
+	/// delete doesn't need to read the header for small blocks.
+	///
+	/// Slab chunks are never returned to the backing heap.
+	///
+	class Slab_allocator
+	{
+		public:
+			/// Alignment of all blocks, given that the backing heap
+			/// aligns at least as much
+			static const size_t ALIGN = 16;
+
+			/// Largest block served by the size classes
+			static const size_t MAX_SLAB_SIZE = 2048;
+
+			/// Size classes: steps of 16 up to 128, then four per power of two
+			static const unsigned CLASSES = 24;
+
+			static const size_t CHUNK_SIZE = 64 * 1024;
+
+			/// Blocks moved between a cache and the central list at once
+			static const unsigned BATCH = 32;
+
+			static const unsigned CACHES = 8;
+
+			/// \return the size class of blocks of size bytes.
+			///
+			/// \pre 0 < size <= MAX_SLAB_SIZE
+			///
+			static unsigned class_of( const size_t size )
+			{
+				if ( size <= 128 )
+				{
+					return ( size - 1 ) >> 4;
+				}
+
+				const unsigned high = sizeof( unsigned long ) * 8 - 1 - __builtin_clzl( size - 1 );
+				return 8 + ( high - 7 ) * 4 + ( ( size - 1 ) >> ( high - 2 ) ) - 4;
+			}
+
+			/// \return the size of the blocks of class c.
+			static size_t class_size( const unsigned c )
+			{
+				if ( c < 8 )
+				{
+					return ( c + 1 ) << 4;
+				}
+
+				const unsigned high = 7 + ( c - 8 ) / 4;
+				return size_t( ( c - 8 ) % 4 + 5 ) << ( high - 2 );
+			}
+
+		private:
+			/// Precedes every block
+			struct alignas( ALIGN ) Header
+			{
+				unsigned cls;             // size class, LARGE for heap blocks
+				unsigned short backing;   // backing heap of LARGE blocks
+				unsigned short tag;       // id of the Alloc_tag
+				size_t size;              // size of LARGE blocks
+			};
+
+			static const unsigned LARGE = ~0U;
+
+			/// Backing of blocks from the Large_allocator
+			static const unsigned DATASPACE = 2;
+
+			/// Free block, the link overlays the memory of the user
+			struct Free_block
+			{
+				Free_block *next;
+			};
+
+			struct Free_list
+			{
+				Free_block *head;
+				unsigned count;
+
+				Free_list(): head( nullptr ), count( 0 ) {}
+
+				void push( Free_block *b )
+				{
+					b->next = head;
+					head = b;
+					++count;
+				}
+
+				Free_block *pop()
+				{
+					Free_block *b = head;
+					head = b->next;
+					--count;
+					return b;
+				}
+			};
+
+			struct Cache
+			{
+				Genode::Lock lock;
+				Free_list lists[CLASSES];
+			};
+
+			Cache_aligned<Cache> _caches[CACHES];
+
+			Genode::Lock _central_lock;
+			Free_list _central[CLASSES];
+
+			Genode::Allocator *_backing[2];
+			unsigned _current;
+			Large_allocator *_large;
+
+			Slab_allocator( const Slab_allocator & );
+			Slab_allocator &operator=( const Slab_allocator & );
+
+			void *_alloc_large( size_t size, unsigned tag );
+			void _free_large( Header *header );
+			bool _carve( unsigned cls );
+			bool _refill( Free_list &list, unsigned cls );
+			void _drain( Free_list &list, unsigned cls );
+
+			void _free_slab( Header *header, const unsigned cls );
+
+		public:
+			Slab_allocator();
+
+			/// Back the allocator by heap from now on. Blocks allocated
+			/// before are still freed to the heap they came from.
+			void backing( Genode::Allocator &heap );
+
+			/// Take blocks from Large_allocator::THRESHOLD bytes on
+			/// from large.
+			void large( Large_allocator &large );
+
+			/// \return the dataspace of a block from the Large_allocator,
+			///         or an invalid capability for other blocks.
+			///
+			/// \param offset  receives the offset of p in the dataspace
+			///
+			Genode::Ram_dataspace_capability dataspace( const void *p, size_t &offset ) const;
+
+			/// \return block of at least size bytes, aligned at ALIGN, or
+			///         nullptr when out of memory.
+			///
+			/// \param tag     id of the Alloc_tag to account the block to
+			/// \param caller  return address of the allocating code, for
+			///                the Alloc_stats call sites
+			///
+			void *alloc( size_t size, unsigned tag = 0, void *caller = nullptr );
+
+			void free( void *p );
+
+			/// Free p, which was allocated with size bytes.
+			void free( void *p, size_t size );
+
+			/// Carve chunks until the central list holds n blocks of size
+			/// bytes, so they are allocated without growing. Does nothing
+			/// for blocks larger than MAX_SLAB_SIZE.
+			///
+			/// \return false when out of memory.
+			///
+			bool reserve( size_t size, size_t n );
+
+			static Slab_allocator &instance();
+	};
+
+	///
+	/// Names a code path in the allocation statistics. Allocate with
+	/// new ( tag ) to account the object to the tag.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// static Csl::Alloc_tag sa_tag( "ike sa" );
+	/// Ike_sa *sa = new ( sa_tag ) Ike_sa( ... );   // delete as usual
+	///
+	/// \endverbatim
+	///
+	class Alloc_tag
+	{
+		public:
+			/// Tags in a component, id 0 is for untagged allocations
+			static const unsigned MAX_TAGS = 64;
+
+		private:
+			const char *_name;
+			unsigned _id;
+
+			Alloc_tag( const Alloc_tag & );
+			Alloc_tag &operator=( const Alloc_tag & );
+
+		public:
+			/// Constructor, tags are meant to be static. When there are
+			/// MAX_TAGS tags already, allocations go untagged.
+			Alloc_tag( const char *name );
+
+			const char *name() const
+			{
+				return _name;
+			}
+
+			unsigned id() const
+			{
+				return _id;
+			}
+
+			/// \return the tag with id, or nullptr.
+			static const Alloc_tag *by_id( unsigned id );
+	};
+
+	///
+	/// Allocation statistics of the global operator new, collected when
+	/// libcsl is built with CSL_ALLOC_STATS (see lib/mk/libcsl.mk).
+	/// Without it, all counts are 0.
+	///
+	/// Bytes are counted in blocks: the size of the size class for slab
+	/// blocks, the requested size for larger blocks. Headers aren't
+	/// counted.
+	///
+	/// One in SAMPLE_PERIOD allocations records the return address of
+	/// its caller, resolve the addresses of the busiest call sites with
+	/// addr2line against the binary (or shared library) of the component.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Alloc_stats::log();                    // dump to the log now
+	/// Csl::Alloc_stats_reporter r( env, 5000 );   // or as "alloc_stats" report
+	///
+	/// \endverbatim
+	///
+	class Alloc_stats
+	{
+		public:
+			static const unsigned SAMPLE_PERIOD = 64;
+
+			/// Call sites kept, further sites are counted as dropped
+			static const unsigned SITES = 128;
+
+			/// Index of the large blocks in allocations()
+			static const unsigned LARGE = Slab_allocator::CLASSES;
+
+			struct Site
+			{
+				void *address;
+				unsigned long samples;
+				unsigned long bytes;
+			};
+
+			/// Account an allocation of bytes to tag. Called by the
+			/// allocator.
+			static void allocated( unsigned cls, size_t bytes, unsigned tag, void *caller );
+
+			/// Account a free. Called by the allocator.
+			static void freed( unsigned cls, size_t bytes, unsigned tag );
+
+			static bool enabled();
+
+			/// \return the bytes allocated and not freed.
+			static long live_bytes();
+
+			/// \return the highest live_bytes() since the start, or since
+			///         reset_peak().
+			static long peak_bytes();
+
+			static void reset_peak();
+
+			/// \return the number of allocations of size class cls, or of
+			///         large blocks for LARGE.
+			static unsigned long allocations( unsigned cls );
+
+			/// \return the number of allocations with tag id.
+			static unsigned long tag_allocations( unsigned id );
+
+			/// \return the live bytes of tag id.
+			static long tag_live_bytes( unsigned id );
+
+			/// \return the samples that didn't fit in the site table.
+			static unsigned long dropped_samples();
+
+			/// Call f( const Site & ) for every sampled call site.
+			template <typename FUNC>
+			static void for_each_site( FUNC const &f )
+			{
+				Site sites[SITES];
+				const unsigned n = _copy_sites( sites );
+
+				for ( unsigned i = 0; i < n; ++i )
+				{
+					f( const_cast<const Site &>( sites[i] ) );
+				}
+			}
+
+			/// Write the statistics to the log. Also call it at exit to
+			/// find leaks: live bytes per tag and class.
+			static void log();
+
+		private:
+			static unsigned _copy_sites( Site *sites );
+	};
+
+	///
+	/// Reports the Alloc_stats as "alloc_stats" every period_ms
+	/// milliseconds. Without CSL_ALLOC_STATS the counts are 0.
+	///
+	class Alloc_stats_reporter
+	{
+		private:
+			struct Impl;
+			Impl *_impl;
+
+			Alloc_stats_reporter( const Alloc_stats_reporter & );
+			Alloc_stats_reporter &operator=( const Alloc_stats_reporter & );
+
+		public:
+			Alloc_stats_reporter( Genode::Env &env, unsigned long period_ms );
+			~Alloc_stats_reporter();
+
+			/// Generate a report now.
+			void report();
+	};
+
+	///
+	/// Back the global operator new by a heap of env, and large blocks by
+	/// RAM dataspaces of env. Call it first thing in
+	/// Component::construct(); allocations before it are served from the
+	/// deprecated Genode::env()->heap().
+	///
+	void init_allocator( Genode::Env &env );
+} // namespace Csl
+
+void *operator new( Csl::size_t size, const Csl::Alloc_tag &tag );
+void *operator new[]( Csl::size_t size, const Csl::Alloc_tag &tag );
+void operator delete( void *p, const Csl::Alloc_tag &tag );
+void operator delete[]( void *p, const Csl::Alloc_tag &tag );
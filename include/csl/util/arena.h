@@ -0,0 +1,119 @@
+///
+/// \file       arena.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Bump-pointer allocator for request-scoped work
+///
+
+#pragma once
+
+#include <base/env.h>
+#include <base/allocator.h>
+
+#include <csl/util/stdint.h>
+
+namespace Csl
+{
+	///
+	/// Monotonic allocator: allocating bumps a pointer, free() does
+	/// nothing, and reset() frees everything at once.
+	///
+	/// The arena grows in chunks of RAM dataspaces. reset() keeps the
+	/// first chunk, so an arena that is reset per request doesn't
+	/// allocate dataspaces in the steady state.
+	///
+	/// Arena is a Genode::Allocator, so it can be passed to Genode APIs
+	/// and to the libcsl containers that take an allocator (List,
+	/// string). Destructors still run when the objects are destroyed,
+	/// only the memory is kept until reset(). An arena is not thread
+	/// safe.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Arena _arena( env );
+	///
+	/// void handle( const Message &m ) {
+	///   Csl::List<Csl::string> names( _arena );
+	///   ... parse m into names ...
+	///   respond( names );
+	///   names.clear();
+	///   _arena.reset();      // one free for all strings and list nodes
+	/// }
+	///
+	/// \endverbatim
+	///
+	class Arena: public Genode::Allocator
+	{
+		public:
+			static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+			/// Alignment of all allocations
+			static const size_t ALIGN = 16;
+
+		private:
+			/// Start of every chunk
+			struct alignas( ALIGN ) Chunk
+			{
+				Genode::Ram_dataspace_capability ds;
+				Chunk *next;
+				size_t size;
+			};
+
+			Genode::Ram_session &_ram;
+			Genode::Region_map &_rm;
+			const size_t _chunk_size;
+
+			Chunk *_chunks;      // current chunk first
+			char *_top;
+			char *_end;
+			size_t _consumed;
+
+			Arena( const Arena & );
+			Arena &operator=( const Arena & );
+
+			bool _grow( size_t size );
+			void _release( Chunk *chunk );
+
+		public:
+			/// Constructor
+			///
+			/// \param env         environment to allocate dataspaces from
+			/// \param chunk_size  size of the dataspaces, larger
+			///                    allocations get a dataspace of their own.
+			///
+			Arena( Genode::Env &env, size_t chunk_size = DEFAULT_CHUNK_SIZE );
+
+			~Arena();
+
+			/// Free everything allocated from the arena.
+			void reset();
+
+			bool alloc( size_t size, void **out_addr ) override;
+
+			/// Does nothing, memory is freed by reset()
+			void free( void *, size_t ) override {}
+
+			/// \return the bytes allocated since the last reset()
+			size_t consumed() const override
+			{
+				return _consumed;
+			}
+
+			size_t overhead( size_t ) const override
+			{
+				return 0;
+			}
+
+			bool need_size_for_free() const override
+			{
+				return false;
+			}
+	};
+} // namespace Csl
@@ -0,0 +1,367 @@
+///
+/// \file       async_channel.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Request/response channel with multiple requests in flight
+///
+
+#pragma once
+
+#include <util/construct_at.h>
+
+#include <csl/util/thread.h>
+#include <csl/util/atomic.h>
+#include <csl/util/clock.h>
+#include <csl/util/sync.h>
+
+namespace Csl
+{
+	///
+	/// Like Channel, but submit() doesn't wait for the reply. Instead
+	/// it returns a Future, which is used to pick up the reply later.
+	/// Up to DEPTH requests can be in flight; submit() blocks when all
+	/// of them are in use.
+	///
+	/// The server thread handles requests one by one with proc(), or
+	/// handles all pending requests per wakeup with proc_batch().
+	///
+	/// Clients that must not block, such as an Async_task, submit with
+	/// try_submit(), and wait with ready( waiter ) instead of get(): the
+	/// waiter is woken when the reply comes in.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Async_channel<Key, Key_id> lookups;
+	///
+	/// // client: pipeline the requests, then collect the replies
+	/// auto a = lookups.submit( id_a );
+	/// auto b = lookups.submit( id_b );
+	/// use( a.get(), b.get() );
+	///
+	/// // server
+	/// while ( true ) {
+	///   lookups.proc_batch( [&]( const Key_id &id ) { return db.find( id ); } );
+	/// }
+	///
+	/// \endverbatim
+	///
+	template <typename REPLY, typename MESSAGE, size_t DEPTH = 16>
+	class Async_channel
+	{
+		private:
+			enum State { FREE, PENDING, READY, ABANDONED };
+
+			///
+			/// Storage for a request in flight
+			///
+			struct Slot
+			{
+				Atomic_variable<int> state;
+				Atomic_variable<Wakeable *> waiter;
+				Semaphore ready;
+				alignas( REPLY ) char reply[sizeof( REPLY )];
+
+				Slot(): state( int( FREE ) ), waiter( nullptr ), ready( 0 ) {}
+
+				REPLY &value()
+				{
+					return *reinterpret_cast<REPLY *>( reply );
+				}
+			};
+
+			struct Request
+			{
+				size_t id;
+				MESSAGE message;
+
+				Request( size_t id, const MESSAGE &message ): id( id ), message( message ) {}
+			};
+
+			Slot _slots[DEPTH];
+			Blocking_queue<size_t, DEPTH> _free;
+			Blocking_queue<Request, DEPTH> _requests;
+
+			Async_channel( const Async_channel & );
+			Async_channel &operator=( const Async_channel & );
+
+			void _release( size_t id )
+			{
+				_slots[id].value().~REPLY();
+				_slots[id].waiter.store( nullptr );
+				_slots[id].state.store( FREE );
+				_free.enqueue( id );
+			}
+
+		public:
+			///
+			/// Handle to the reply of a submitted request. Futures can
+			/// be moved but not copied. Destroying a Future without
+			/// calling get() discards the reply.
+			///
+			class Future
+			{
+				private:
+					friend class Async_channel;
+
+					Async_channel *_channel;
+					size_t _id;
+
+					Future( Async_channel &channel, size_t id ): _channel( &channel ), _id( id ) {}
+
+					Future( const Future & );
+					Future &operator=( const Future & );
+
+					Slot &_slot()
+					{
+						return _channel->_slots[_id];
+					}
+
+					REPLY _take()
+					{
+						REPLY reply = _slot().value();
+						_channel->_release( _id );
+						_channel = nullptr;
+						return reply;
+					}
+
+					void _abandon()
+					{
+						if ( nullptr == _channel )
+						{
+							return;
+						}
+
+						int expected = PENDING;
+
+						if ( not _slot().state.compare_exchange( expected, ABANDONED ) )
+						{
+							// The reply is in, discard it
+							_slot().ready.down();
+							_channel->_release( _id );
+						}
+
+						_channel = nullptr;
+					}
+
+				public:
+					/// Invalid future, to assign a submitted one to later.
+					Future(): _channel( nullptr ), _id( 0 ) {}
+
+					Future( Future &&other ): _channel( other._channel ), _id( other._id )
+					{
+						other._channel = nullptr;
+					}
+
+					/// Take over other, discarding the reply of this future.
+					Future &operator=( Future &&other )
+					{
+						if ( this != &other )
+						{
+							_abandon();
+							_channel = other._channel;
+							_id = other._id;
+							other._channel = nullptr;
+						}
+
+						return *this;
+					}
+
+					~Future()
+					{
+						_abandon();
+					}
+
+					/// \return false iff the future was moved from, or its
+					///         reply was taken already.
+					bool valid() const
+					{
+						return nullptr != _channel;
+					}
+
+					/// \return true iff get() won't block.
+					bool ready() const
+					{
+						return valid() && READY == _channel->_slots[_id].state.load();
+					}
+
+					/// Like ready(), but when the reply isn't in yet, have
+					/// waiter woken when it comes in. The waiter must stay
+					/// alive until the future is destroyed.
+					bool ready( Wakeable &waiter )
+					{
+						if ( not valid() )
+						{
+							return false;
+						}
+
+						_slot().waiter.store( &waiter );
+						return ready();
+					}
+
+					/// Wait for the reply, and take it.
+					///
+					/// \pre valid()
+					///
+					REPLY get()
+					{
+						cslassert( valid() );
+						_slot().ready.down();
+						return _take();
+					}
+
+					/// Wait at most timeout_ms milliseconds for the reply.
+					///
+					/// \param reply  receives the reply.
+					///
+					/// \return false iff the reply didn't arrive in time. The
+					///         future stays valid in that case.
+					///
+					bool get_for( REPLY &reply, unsigned long timeout_ms, Clock &clock )
+					{
+						cslassert( valid() );
+						Deadline deadline( clock, timeout_ms );
+
+						do
+						{
+							if ( ready() )
+							{
+								_slot().ready.down();
+								reply = _take();
+								return true;
+							}
+						}
+						while ( deadline.wait() );
+
+						return false;
+					}
+			};
+
+			Async_channel()
+			{
+				for ( size_t i = 0; i < DEPTH; ++i )
+				{
+					_free.enqueue( i );
+				}
+			}
+
+			/// Submit a message, blocks while DEPTH requests are in flight.
+			///
+			/// \return future for the reply
+			///
+			Future submit( const MESSAGE &message )
+			{
+				const size_t id = _free.dequeue();
+				_slots[id].state.store( PENDING );
+				_requests.enqueue( Request( id, message ) );
+				return Future( *this, id );
+			}
+
+			/// Submit a message when a request can be put in flight
+			/// without blocking, for callers that must not block, such as
+			/// an Async_task.
+			///
+			/// \param future  receives the future for the reply.
+			///
+			/// \return false iff DEPTH requests are in flight.
+			///
+			bool try_submit( const MESSAGE &message, Future &future )
+			{
+				size_t id = 0;
+
+				if ( not _free.try_dequeue( id ) )
+				{
+					return false;
+				}
+
+				_slots[id].state.store( PENDING );
+				_requests.enqueue( Request( id, message ) );
+				future = Future( *this, id );
+				return true;
+			}
+
+			/// Reply to request id.
+			///
+			/// \param id     the id of the request, as passed to the
+			///               handler of proc(), or returned by get().
+			/// \param reply  the reply.
+			///
+			void put( size_t id, const REPLY &reply )
+			{
+				Slot &slot = _slots[id];
+				Genode::construct_at<REPLY>( slot.reply, reply );
+				int expected = PENDING;
+
+				if ( slot.state.compare_exchange( expected, READY ) )
+				{
+					// The future waits for ready before it goes away, so
+					// the waiter is still there
+					Wakeable *waiter = slot.waiter.load();
+
+					if ( nullptr != waiter )
+					{
+						waiter->wake();
+					}
+
+					slot.ready.up();
+					return;
+				}
+
+				// Nobody is interested anymore
+				cslassert( ABANDONED == expected );
+				_release( id );
+			}
+
+			/// Wait for a request.
+			///
+			/// \param id  receives the id to pass to put().
+			///
+			/// \return the message
+			///
+			const MESSAGE get( size_t &id )
+			{
+				const Request request = _requests.dequeue();
+				id = request.id;
+				return request.message;
+			}
+
+			/// Wait for a request, reply with f( message ).
+			template <typename FUNC>
+			void proc( FUNC const &f )
+			{
+				size_t id = 0;
+				const MESSAGE message = get( id );
+				put( id, f( message ) );
+			}
+
+			/// Wait for a request, then handle it and all other requests
+			/// that are pending, up to max requests.
+			///
+			/// \param f    called as REPLY f( const MESSAGE & ) per request.
+			/// \param max  maximum number of requests handled.
+			///
+			/// \return the number of requests handled.
+			///
+			template <typename FUNC>
+			size_t proc_batch( FUNC const &f, const size_t max = DEPTH )
+			{
+				Request request = _requests.dequeue();
+				size_t handled = 0;
+
+				do
+				{
+					put( request.id, f( request.message ) );
+					++handled;
+				}
+				while ( handled < max && _requests.try_dequeue( request ) );
+
+				return handled;
+			}
+	};
+} // namespace Csl
@@ -0,0 +1,314 @@
+///
+/// \file       async_task.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Stackless tasks, resumed by a scheduler on the entrypoint
+///
+
+#pragma once
+
+#include <base/signal.h>
+
+#include <csl/util/reactor.h>
+#include <csl/util/thread.h>
+#include <csl/util/atomic.h>
+#include <csl/util/sync.h>
+
+///
+/// Start of the body of Async_task::run().
+///
+#define CSL_TASK_BEGIN \
+	switch ( _resume_point ) { case 0:
+
+///
+/// Suspend until the task is woken, and cond holds. cond is evaluated
+/// again on every wakeup.
+///
+#define CSL_TASK_AWAIT( cond ) \
+	do { \
+		_resume_point = __LINE__; case __LINE__: \
+		if ( not ( cond ) ) return SUSPENDED; \
+	} while ( 0 )
+
+///
+/// Suspend, and let the other ready tasks run first.
+///
+#define CSL_TASK_YIELD() \
+	do { \
+		_resume_point = __LINE__; \
+		wake(); \
+		return SUSPENDED; case __LINE__:; \
+	} while ( 0 )
+
+///
+/// End of the body of Async_task::run().
+///
+#define CSL_TASK_END \
+	} _resume_point = 0; return DONE
+
+namespace Csl
+{
+	class Task_scheduler;
+
+	///
+	/// Task that suspends without blocking a thread.
+	///
+	/// A task is a resumable state machine: run() is called whenever
+	/// the task is woken, and continues where it suspended last time.
+	/// Write run() between CSL_TASK_BEGIN and CSL_TASK_END, and suspend
+	/// with CSL_TASK_AWAIT or CSL_TASK_YIELD. A task costs the size of
+	/// its object instead of a thread stack, so thousands can be in
+	/// flight on a single entrypoint.
+	///
+	/// run() returns at every suspension, so local variables don't
+	/// survive it: keep state in members. Don't suspend in a switch
+	/// statement of your own.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// struct Rekey: Csl::Async_task {
+	///   Csl::Async_channel<Key, Key_id> &_hsm;
+	///   Csl::Async_channel<Key, Key_id>::Future _key;
+	///   Csl::Async_timeout _retry;              // constructed with the scheduler
+	///
+	///   Status run() override {
+	///     CSL_TASK_BEGIN;
+	///     while ( true ) {
+	///       while ( not _hsm.try_submit( _id, _key ) ) {
+	///         CSL_TASK_YIELD();                    // all requests in flight
+	///       }
+	///       CSL_TASK_AWAIT( _key.ready( *this ) );  // no thread waits
+	///       install( _key.get() );
+	///       _retry.start( 60 * 1000 );
+	///       CSL_TASK_AWAIT( _retry.expired( *this ) );
+	///     }
+	///     CSL_TASK_END;
+	///   }
+	/// };
+	///
+	/// \endverbatim
+	///
+	class Async_task: public Wakeable
+	{
+		public:
+			enum Status { SUSPENDED, DONE };
+
+		private:
+			friend class Task_scheduler;
+
+			Task_scheduler *_scheduler;
+			Atomic_variable<bool> _woken;
+			bool _done;
+
+			Async_task( const Async_task & );
+			Async_task &operator=( const Async_task & );
+
+		protected:
+			/// Where run() continues, maintained by the CSL_TASK macros.
+			unsigned _resume_point;
+
+			/// Run the task until it suspends or is done.
+			virtual Status run() = 0;
+
+			/// Called on the entrypoint after run() returned DONE. A
+			/// task that was allocated by its spawner may delete itself
+			/// here.
+			virtual void finished() {}
+
+		public:
+			Async_task(): _scheduler( nullptr ), _woken( true ), _done( false ),
+				_resume_point( 0 ) {}
+
+			virtual ~Async_task() {}
+
+			/// Have the scheduler resume the task. Wakeups coalesce until
+			/// the task runs, and are ignored once it is done. Can be
+			/// called from any thread.
+			void wake() override;
+
+			/// \return true iff the task runs on a scheduler and isn't
+			///         done.
+			bool active() const
+			{
+				return nullptr != _scheduler;
+			}
+	};
+
+	///
+	/// Runs tasks on the entrypoint of a reactor.
+	///
+	/// Woken tasks are queued and resumed in batches, so tasks that
+	/// wake each other don't recurse, and the other event sources of
+	/// the reactor get their turn in between.
+	///
+	class Task_scheduler
+	{
+		private:
+			friend class Async_task;
+
+			Reactor &_reactor;
+			Queue<Async_task *> _woken;
+			Reactor::Notifier _notifier;
+			unsigned long _active;
+
+			Task_scheduler( const Task_scheduler & );
+			Task_scheduler &operator=( const Task_scheduler & );
+
+			void _wake( Async_task &task );
+			void _run( Async_task &task );
+			void _finish( Async_task &task );
+
+		public:
+			Task_scheduler( Reactor &reactor );
+
+			/// Tasks must not be woken anymore.
+			~Task_scheduler()
+			{
+				_reactor.remove( _notifier );
+			}
+
+			/// Start a task, it runs for the first time from the
+			/// entrypoint. A task runs on one scheduler at a time.
+			void spawn( Async_task &task );
+
+			/// \return the number of tasks spawned and not done.
+			unsigned long active() const
+			{
+				return _active;
+			}
+
+			Reactor &reactor()
+			{
+				return _reactor;
+			}
+	};
+
+	///
+	/// Timeout that a task awaits.
+	///
+	class Async_timeout: private Reactor::Handler
+	{
+		private:
+			Reactor::Timeout _timeout;
+			Wakeable *_waiter;
+			bool _expired;
+
+			void handle() override
+			{
+				_expired = true;
+
+				if ( nullptr != _waiter )
+				{
+					_waiter->wake();
+				}
+			}
+
+		public:
+			Async_timeout( Task_scheduler &scheduler ): _timeout( scheduler.reactor(), *this ),
+				_waiter( nullptr ), _expired( false ) {}
+
+			/// Expire ms milliseconds from now.
+			void start( unsigned long ms )
+			{
+				_expired = false;
+				_timeout.once( ms );
+			}
+
+			void cancel()
+			{
+				_timeout.cancel();
+			}
+
+			/// \return true iff the timeout expired, otherwise waiter is
+			///         woken when it does.
+			bool expired( Wakeable &waiter )
+			{
+				_waiter = &waiter;
+				return _expired;
+			}
+	};
+
+	///
+	/// Genode signal that a task awaits, e.g. a Descriptive_signal
+	/// receiver, or the packet acknowledgements of a file system
+	/// session.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Async_signal _ack_avail( scheduler );
+	/// _fs.sigh_ack_avail( _ack_avail.cap() );
+	/// ...
+	/// CSL_TASK_AWAIT( _ack_avail.take( *this ) );
+	/// while ( _fs.tx()->ack_avail() ) { ... }
+	///
+	/// \endverbatim
+	///
+	/// Its signal handler is removed from the reactor when the
+	/// Async_signal is destroyed.
+	///
+	class Async_signal
+	{
+		private:
+			Reactor &_reactor;
+			Genode::Signal_context_capability _cap;
+			Wakeable *_waiter;
+			unsigned long _pending;
+
+			void _handle()
+			{
+				++_pending;
+
+				if ( nullptr != _waiter )
+				{
+					_waiter->wake();
+				}
+			}
+
+			Async_signal( const Async_signal & );
+			Async_signal &operator=( const Async_signal & );
+
+		public:
+			Async_signal( Task_scheduler &scheduler ): _reactor( scheduler.reactor() ),
+				_waiter( nullptr ), _pending( 0 )
+			{
+				_cap = _reactor.on_signal( [this]() { _handle(); } );
+			}
+
+			~Async_signal()
+			{
+				_reactor.remove( _cap );
+			}
+
+			/// \return the capability to install as signal handler.
+			Genode::Signal_context_capability cap() const
+			{
+				return _cap;
+			}
+
+			/// Consume the signals that came in. Signals coalesce, so
+			/// handle everything that is pending after a take().
+			///
+			/// \return false iff no signal came in, waiter is woken when
+			///         one does.
+			bool take( Wakeable &waiter )
+			{
+				_waiter = &waiter;
+
+				if ( 0 == _pending )
+				{
+					return false;
+				}
+
+				_pending = 0;
+				return true;
+			}
+	};
+} // namespace Csl
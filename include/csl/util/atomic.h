@@ -0,0 +1,300 @@
+///
+/// \file       atomic.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Variables that can be shared between threads
+///
+
+#pragma once
+
+#include <base/lock.h>
+#include <csl/util/type_traits.h>
+#include <csl/util/lock_profile.h>
+
+namespace Csl
+{
+	///
+	/// Memory orderings of atomic operations, with the semantics of
+	/// the C++11 memory model.
+	///
+	enum class Memory_order : int
+	{
+		relaxed = __ATOMIC_RELAXED,
+		consume = __ATOMIC_CONSUME,
+		acquire = __ATOMIC_ACQUIRE,
+		release = __ATOMIC_RELEASE,
+		acq_rel = __ATOMIC_ACQ_REL,
+		seq_cst = __ATOMIC_SEQ_CST
+	};
+
+	inline void atomic_thread_fence( Memory_order order = Memory_order::seq_cst )
+	{
+		__atomic_thread_fence( static_cast<int>( order ) );
+	}
+
+	///
+	/// Tell the cpu we're spinning, so it can back off a little.
+	///
+	inline void cpu_relax()
+	{
+#if defined(__i386__) || defined(__x86_64__)
+		__builtin_ia32_pause();
+#elif defined(__arm__) || defined(__aarch64__)
+		asm volatile( "yield" ::: "memory" );
+#else
+		asm volatile( "" ::: "memory" );
+#endif
+	}
+
+	///
+	/// How Atomic_variable<T> implements its operations for T.
+	///
+	enum class Atomic_impl { locked, lock_free, integral, pointer };
+
+	template <typename T>
+	struct Atomic_kind
+	{
+		static constexpr bool LOCK_FREE = Is_trivially_copyable<T>::VALUE
+		                                   && ( sizeof( T ) == 1 || sizeof( T ) == 2
+		                                        || sizeof( T ) == 4 || sizeof( T ) == 8 )
+		                                   && __atomic_always_lock_free( sizeof( T ), 0 );
+
+		static constexpr Atomic_impl VALUE =
+		    not LOCK_FREE ? Atomic_impl::locked
+		    : Is_pointer<T>::VALUE ? Atomic_impl::pointer
+		    : ( Is_integral<T>::VALUE && not Is_same<T, bool>::VALUE ) ? Atomic_impl::integral
+		    : Atomic_impl::lock_free;
+	};
+
+	///
+	/// Operations shared by all lock-free Atomic_variables.
+	///
+	template <typename TYPE>
+	class Atomic_base
+	{
+		protected:
+			TYPE _var;
+
+			static constexpr int _failure_order( Memory_order order )
+			{
+				return order == Memory_order::acq_rel ? __ATOMIC_ACQUIRE
+				       : order == Memory_order::release ? __ATOMIC_RELAXED
+				       : static_cast<int>( order );
+			}
+
+			// can't copy
+			Atomic_base &operator=( const Atomic_base &other );
+			Atomic_base( const Atomic_base &other );
+		public:
+			template <typename ...ARGS>
+			Atomic_base( const ARGS &...args ): _var( args... ) {}
+
+			TYPE load( Memory_order order = Memory_order::seq_cst ) const
+			{
+				TYPE ret;
+				__atomic_load( &_var, &ret, static_cast<int>( order ) );
+				return ret;
+			}
+
+			void store( TYPE val, Memory_order order = Memory_order::seq_cst )
+			{
+				__atomic_store( &_var, &val, static_cast<int>( order ) );
+			}
+
+			/// Store val, and return the previous value.
+			TYPE exchange( TYPE val, Memory_order order = Memory_order::seq_cst )
+			{
+				TYPE ret;
+				__atomic_exchange( &_var, &val, &ret, static_cast<int>( order ) );
+				return ret;
+			}
+
+			/// Store desired iff the variable holds expected.
+			///
+			/// \param expected  the expected value; on failure it receives
+			///                  the actual value.
+			/// \param desired   the value to store.
+			///
+			/// \return true iff desired was stored.
+			///
+			bool compare_exchange( TYPE &expected, TYPE desired,
+			                       Memory_order order = Memory_order::seq_cst )
+			{
+				return __atomic_compare_exchange( &_var, &expected, &desired, false,
+				                                  static_cast<int>( order ),
+				                                  _failure_order( order ) );
+			}
+
+			TYPE get() const
+			{
+				return load();
+			}
+
+			operator TYPE() const
+			{
+				return load();
+			}
+	};
+
+	///
+	/// Variable shared between threads.
+	///
+	/// Types that fit a lock-free atomic (trivially copyable and of
+	/// size 1, 2, 4 or 8) are accessed with compiler atomics; integral
+	/// and pointer types additionally support arithmetic. Other types
+	/// fall back to a (Profiled_)lock.
+	///
+	template <typename TYPE, Atomic_impl IMPL = Atomic_kind<TYPE>::VALUE>
+	class Atomic_variable
+	{
+		private:
+			TYPE _var;
+			mutable Profiled_lock _lock;
+
+			// can't copy
+			Atomic_variable &operator=( const Atomic_variable &other );
+			Atomic_variable( const Atomic_variable &other );
+		public:
+			template <typename ...ARGS>
+			Atomic_variable( const ARGS &...args ): _var( args... ) {}
+
+			const Atomic_variable &operator=( const TYPE &var )
+			{
+				Profiled_lock::Guard guard( _lock );
+				_var = var;
+				return *this;
+			}
+
+			/// \return a copy, the variable itself may change as soon
+			///         as the lock is released.
+			TYPE get() const
+			{
+				Profiled_lock::Guard guard( _lock );
+				return _var;
+			}
+
+			TYPE exchange( const TYPE &var )
+			{
+				Profiled_lock::Guard guard( _lock );
+				TYPE ret = _var;
+				_var = var;
+				return ret;
+			}
+
+			operator TYPE() const
+			{
+				return get();
+			}
+
+			/// Name the lock in the lock profile.
+			void lock_name( const char *name )
+			{
+				_lock.name( name );
+			}
+	};
+
+	template <typename TYPE>
+	class Atomic_variable<TYPE, Atomic_impl::lock_free>: public Atomic_base<TYPE>
+	{
+		public:
+			using Atomic_base<TYPE>::Atomic_base;
+
+			const Atomic_variable &operator=( const TYPE &var )
+			{
+				this->store( var );
+				return *this;
+			}
+	};
+
+	template <typename TYPE>
+	class Atomic_variable<TYPE, Atomic_impl::integral>: public Atomic_base<TYPE>
+	{
+		public:
+			using Atomic_base<TYPE>::Atomic_base;
+
+			const Atomic_variable &operator=( const TYPE &var )
+			{
+				this->store( var );
+				return *this;
+			}
+
+			/// Add val, and return the previous value.
+			TYPE fetch_add( TYPE val, Memory_order order = Memory_order::seq_cst )
+			{
+				return __atomic_fetch_add( &this->_var, val, static_cast<int>( order ) );
+			}
+
+			/// Subtract val, and return the previous value.
+			TYPE fetch_sub( TYPE val, Memory_order order = Memory_order::seq_cst )
+			{
+				return __atomic_fetch_sub( &this->_var, val, static_cast<int>( order ) );
+			}
+
+			TYPE fetch_and( TYPE val, Memory_order order = Memory_order::seq_cst )
+			{
+				return __atomic_fetch_and( &this->_var, val, static_cast<int>( order ) );
+			}
+
+			TYPE fetch_or( TYPE val, Memory_order order = Memory_order::seq_cst )
+			{
+				return __atomic_fetch_or( &this->_var, val, static_cast<int>( order ) );
+			}
+
+			TYPE operator++()
+			{
+				return fetch_add( 1 ) + 1;
+			}
+
+			TYPE operator--()
+			{
+				return fetch_sub( 1 ) - 1;
+			}
+
+			TYPE operator+=( TYPE val )
+			{
+				return fetch_add( val ) + val;
+			}
+
+			TYPE operator-=( TYPE val )
+			{
+				return fetch_sub( val ) - val;
+			}
+	};
+
+	template <typename TYPE>
+	class Atomic_variable<TYPE, Atomic_impl::pointer>: public Atomic_base<TYPE>
+	{
+		public:
+			using Atomic_base<TYPE>::Atomic_base;
+
+			const Atomic_variable &operator=( const TYPE &var )
+			{
+				this->store( var );
+				return *this;
+			}
+
+			/// Advance the pointer by n elements, and return the previous value.
+			TYPE fetch_add( long n, Memory_order order = Memory_order::seq_cst )
+			{
+				return __atomic_fetch_add( &this->_var, n * sizeof( *this->_var ),
+				                           static_cast<int>( order ) );
+			}
+
+			TYPE fetch_sub( long n, Memory_order order = Memory_order::seq_cst )
+			{
+				return __atomic_fetch_sub( &this->_var, n * sizeof( *this->_var ),
+				                           static_cast<int>( order ) );
+			}
+
+			TYPE operator->() const
+			{
+				return this->load();
+			}
+	};
+} // namespace Csl
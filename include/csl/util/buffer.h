@@ -0,0 +1,268 @@
+///
+/// \file       buffer.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Reference counted byte buffers
+///
+
+#pragma once
+
+#include <csl/util/stdint.h>
+#include <csl/util/atomic.h>
+#include <csl/util/exception.h>
+#include <csl/util/data_descriptor.h>
+
+namespace Csl
+{
+	///
+	/// Owning, reference counted byte buffer.
+	///
+	/// A Buffer is a view on a block of storage that is shared by all
+	/// copies and slices of it. Copying or slicing a Buffer doesn't copy
+	/// the data, and the storage is freed when the last view goes away,
+	/// on whatever thread that happens. Storage and counter are one
+	/// allocation from the global allocator, i.e. from the size classes
+	/// of the Slab_allocator, or a dataspace of its own for large buffers.
+	///
+	/// The storage keeps room in front of and behind the view, so a
+	/// pipeline stage can prepend a header with push() or append a
+	/// trailer with put() without moving the payload. A view only
+	/// writes into storage other views can't see: when the storage is
+	/// shared, or the room is used up, push(), put() and mod() first
+	/// copy the view into storage of its own.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Buffer packet = Csl::Buffer::allocate( len, Esp::HEADER_SIZE );
+	/// receive( packet.mod() );
+	///
+	/// Csl::Buffer payload = packet.slice( 0, len );   // shares the storage
+	/// esp_header( packet.push( Esp::HEADER_SIZE ) );  // no copy
+	/// send( packet );                                 // Data_descriptor
+	///
+	/// \endverbatim
+	///
+	class Buffer
+	{
+		public:
+			/// Headroom of allocate() when none is given
+			static const size_t DEFAULT_HEADROOM = 64;
+
+		private:
+			/// Header of the storage, followed by the data
+			struct alignas( 16 ) Storage
+			{
+				Atomic_variable<unsigned long> refs;
+				size_t capacity;
+
+				Storage( const size_t c ): refs( 1UL ), capacity( c ) {}
+
+				uint8_t *data()
+				{
+					return reinterpret_cast<uint8_t *>( this + 1 );
+				}
+			};
+
+			Storage *_storage;
+			uint8_t *_data;
+			size_t _size;
+
+			Buffer( Storage *storage, uint8_t *data, const size_t size ):
+				_storage( storage ), _data( data ), _size( size ) {}
+
+			static Storage *_allocate( size_t capacity );
+
+			void _acquire()
+			{
+				if ( nullptr != _storage )
+				{
+					_storage->refs.fetch_add( 1UL, Memory_order::relaxed );
+				}
+			}
+
+			void _release()
+			{
+				if ( nullptr != _storage &&
+				     1UL == _storage->refs.fetch_sub( 1UL, Memory_order::acq_rel ) )
+				{
+					_storage->~Storage();
+					::operator delete( _storage );
+				}
+
+				_storage = nullptr;
+			}
+
+			/// Copy the view into new storage with at least headroom and
+			/// tailroom bytes around it.
+			void _reallocate( size_t headroom, size_t tailroom );
+
+		public:
+			/// Empty buffer, without storage.
+			Buffer(): _storage( nullptr ), _data( nullptr ), _size( 0 ) {}
+
+			/// Allocate a buffer.
+			///
+			/// \param size      size of the view.
+			/// \param headroom  room reserved for push().
+			/// \param tailroom  room reserved for put().
+			///
+			/// \return the buffer, its data is not initialized.
+			///
+			static Buffer allocate( size_t size, size_t headroom = DEFAULT_HEADROOM,
+			                        size_t tailroom = 0 );
+
+			/// \return a buffer with a copy of the data subject to dd.
+			static Buffer copy( const Data_descriptor &dd, size_t headroom = DEFAULT_HEADROOM,
+			                    size_t tailroom = 0 );
+
+			Buffer( const Buffer &other ):
+				_storage( other._storage ), _data( other._data ), _size( other._size )
+			{
+				_acquire();
+			}
+
+			Buffer( Buffer &&other ):
+				_storage( other._storage ), _data( other._data ), _size( other._size )
+			{
+				other._storage = nullptr;
+				other._data = nullptr;
+				other._size = 0;
+			}
+
+			Buffer &operator=( const Buffer &other )
+			{
+				if ( this != &other )
+				{
+					Buffer copy( other );
+					*this = static_cast<Buffer &&>( copy );
+				}
+
+				return *this;
+			}
+
+			Buffer &operator=( Buffer &&other )
+			{
+				if ( this != &other )
+				{
+					_release();
+					_storage = other._storage;
+					_data = other._data;
+					_size = other._size;
+					other._storage = nullptr;
+					other._data = nullptr;
+					other._size = 0;
+				}
+
+				return *this;
+			}
+
+			~Buffer()
+			{
+				_release();
+			}
+
+			size_t size() const
+			{
+				return _size;
+			}
+
+			bool empty() const
+			{
+				return 0 == _size;
+			}
+
+			const uint8_t *data() const
+			{
+				return _data;
+			}
+
+			/// \return true iff no other view shares the storage.
+			bool unique() const
+			{
+				return nullptr == _storage ||
+				       1UL == _storage->refs.load( Memory_order::acquire );
+			}
+
+			/// \return the bytes push() can use without copying.
+			size_t headroom() const
+			{
+				return nullptr == _storage ? 0 : _data - _storage->data();
+			}
+
+			/// \return the bytes put() can use without copying.
+			size_t tailroom() const
+			{
+				return nullptr == _storage ? 0 :
+				       _storage->capacity - ( _data - _storage->data() ) - _size;
+			}
+
+			/// \return the view, invalid for a buffer without storage.
+			Data_descriptor dd() const
+			{
+				return nullptr == _data ? Data_descriptor() : Data_descriptor( _data, _size );
+			}
+
+			operator Data_descriptor() const
+			{
+				return dd();
+			}
+
+			/// \return the view for writing. Copies the view first iff
+			///         the storage is shared.
+			Data_descriptor_mod mod()
+			{
+				if ( not unique() )
+				{
+					_reallocate( headroom(), tailroom() );
+				}
+
+				return nullptr == _data ? Data_descriptor_mod() : Data_descriptor_mod( _data, _size );
+			}
+
+			/// \return a buffer viewing size bytes at offset of this
+			///         view, sharing its storage.
+			///
+			/// \throw Out_of_range when the slice exceeds the view.
+			///
+			Buffer slice( size_t offset, size_t size ) const;
+
+			/// \return a buffer viewing this view from offset on.
+			Buffer slice( const size_t offset ) const
+			{
+				return slice( offset, offset <= _size ? _size - offset : 0 );
+			}
+
+			/// Grow the view n bytes at the front, to prepend a header.
+			///
+			/// \return the n new bytes.
+			///
+			Data_descriptor_mod push( size_t n );
+
+			/// Shrink the view n bytes at the front, to strip a header.
+			///
+			/// \return the n stripped bytes.
+			///
+			/// \throw Out_of_range when n exceeds the view.
+			///
+			Data_descriptor pull( size_t n );
+
+			/// Grow the view n bytes at the end, to append data.
+			///
+			/// \return the n new bytes.
+			///
+			Data_descriptor_mod put( size_t n );
+
+			/// Shrink the view n bytes at the end.
+			///
+			/// \throw Out_of_range when n exceeds the view.
+			///
+			void trim( size_t n );
+	};
+} // namespace Csl
@@ -23,6 +23,10 @@
 
 namespace Csl
 {
+	///
+	/// Fixed-size array, zero terminated. It isn't wiped on destruction,
+	/// use Secure_byte_array (csl/crypto/secure_pool.h) for secrets.
+	///
 	template<size_t MAX_SIZE = 1024, typename C = char>
 	struct Byte_array
 	{
@@ -55,10 +59,6 @@ namespace Csl
 
 			Genode::memcpy( val, const_cast<C *>( s.data() ), s.length() );
 		}
-		~Byte_array()
-		{
-			nullify();
-		}
 		Csl::string str() const
 		{
 			return Csl::string( val );
@@ -0,0 +1,81 @@
+///
+/// \file       cache.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Helpers against false sharing
+///
+
+#pragma once
+
+#include <base/stdint.h>
+
+namespace Csl
+{
+	///
+	/// Size of a cache line on the platforms we run on. Data written
+	/// by different threads should not share a line, or every write
+	/// invalidates the line in the caches of the other cores.
+	///
+	static const Genode::size_t CACHE_LINE_SIZE = 64;
+
+	///
+	/// Wraps a T so that neighbouring data can't share a cache line
+	/// with it.
+	///
+	/// The T is padded by a cache line on both sides, instead of being
+	/// aligned: objects are allocated with C++11 new and by allocators
+	/// that align at 16 bytes, so an alignment of 64 wouldn't hold for
+	/// the classes containing a Cache_aligned.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Cache_aligned<Csl::Atomic_variable<long>> _produced;
+	/// Csl::Cache_aligned<Csl::Atomic_variable<long>> _consumed;
+	/// _produced->fetch_add( 1 );
+	///
+	/// \endverbatim
+	///
+	template <typename T>
+	struct Cache_aligned
+	{
+		private:
+			char _front[CACHE_LINE_SIZE];
+
+		public:
+			T value;
+
+		private:
+			char _back[CACHE_LINE_SIZE];
+
+		public:
+			template <typename ...ARGS>
+			Cache_aligned( const ARGS &...args ): value( args... ) {}
+
+			T &operator*()
+			{
+				return value;
+			}
+
+			const T &operator*() const
+			{
+				return value;
+			}
+
+			T *operator->()
+			{
+				return &value;
+			}
+
+			const T *operator->() const
+			{
+				return &value;
+			}
+	};
+} // namespace Csl
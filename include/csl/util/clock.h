@@ -0,0 +1,131 @@
+///
+/// \file       clock.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Pluggable time source and deadlines for timed operations
+///
+
+#pragma once
+
+#include <base/env.h>
+#include <timer_session/connection.h>
+
+namespace Csl
+{
+	///
+	/// Source of time used by the timed (*_for) operations of the
+	/// queues and channels. Implement this interface in order to plug
+	/// in another time source, e.g. a fake clock in tests.
+	///
+	class Clock
+	{
+		public:
+			/// \return milliseconds elapsed since some fixed point in time.
+			virtual unsigned long elapsed_ms() = 0;
+
+			/// Sleep for (at least) ms milliseconds.
+			virtual void msleep( unsigned long ms ) = 0;
+
+			virtual ~Clock() {}
+	};
+
+	///
+	/// Clock backed by a Genode timer session.
+	///
+	class Timer_clock: public Clock
+	{
+		private:
+			Timer::Connection _timer;
+		public:
+			explicit Timer_clock( Genode::Env &env ): _timer( env ) {}
+
+			unsigned long elapsed_ms() override
+			{
+				return _timer.elapsed_ms();
+			}
+
+			void msleep( unsigned long ms ) override
+			{
+				_timer.msleep( ms );
+			}
+	};
+
+	///
+	/// A point in time after which a timed operation gives up.
+	///
+	/// Waiting is done by sleeping with an exponential backoff, so a
+	/// waiter neither burns a core nor oversleeps the deadline by more
+	/// than MAX_BACKOFF_MS.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Deadline deadline( clock, 20 );
+	/// do {
+	///   if ( try_something() ) return true;
+	/// } while ( deadline.wait() );
+	/// return false; // timed out
+	///
+	/// \endverbatim
+	///
+	class Deadline
+	{
+		private:
+			static const unsigned long MAX_BACKOFF_MS = 8;
+
+			Clock &_clock;
+			unsigned long _end;
+			unsigned long _backoff;
+		public:
+			/// Constructor
+			///
+			/// \param clock       time source
+			/// \param timeout_ms  milliseconds from now until the deadline expires
+			///
+			Deadline( Clock &clock, unsigned long timeout_ms ):
+				_clock( clock ), _end( clock.elapsed_ms() + timeout_ms ), _backoff( 1 )
+			{}
+
+			/// \return milliseconds left before the deadline expires.
+			unsigned long remaining()
+			{
+				const unsigned long now = _clock.elapsed_ms();
+				return now >= _end ? 0 : _end - now;
+			}
+
+			bool expired()
+			{
+				return 0 == remaining();
+			}
+
+			/// Sleep a while before the caller retries.
+			///
+			/// \return false iff the deadline expired, hence the caller
+			///         should not retry.
+			///
+			bool wait()
+			{
+				const unsigned long left = remaining();
+
+				if ( 0 == left )
+				{
+					return false;
+				}
+
+				_clock.msleep( _backoff < left ? _backoff : left );
+
+				if ( _backoff < MAX_BACKOFF_MS )
+				{
+					_backoff *= 2;
+				}
+
+				return true;
+			}
+	};
+} // namespace Csl
@@ -0,0 +1,447 @@
+///
+/// \file       codec.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Cursors to read and write binary wire formats
+///
+
+#pragma once
+
+#include <csl/util/stdint.h>
+#include <csl/util/assert.h>
+#include <csl/util/exception.h>
+#include <csl/util/data_descriptor.h>
+
+namespace Csl
+{
+	enum class Byte_order { big, little };
+
+	namespace Codec
+	{
+		static constexpr Byte_order HOST =
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		    Byte_order::little;
+#else
+		    Byte_order::big;
+#endif
+
+		inline uint8_t  byte_swap( const uint8_t v )  { return v; }
+		inline uint16_t byte_swap( const uint16_t v ) { return __builtin_bswap16( v ); }
+		inline uint32_t byte_swap( const uint32_t v ) { return __builtin_bswap32( v ); }
+		inline uint64_t byte_swap( const uint64_t v ) { return __builtin_bswap64( v ); }
+
+		///
+		/// Unaligned loads and stores. __builtin_memcpy of a constant
+		/// size compiles to a single move, unlike Genode::memcpy.
+		///
+		template <typename T, Byte_order O>
+		inline T load( const uint8_t *p )
+		{
+			T v;
+			__builtin_memcpy( &v, p, sizeof( T ) );
+			return O == HOST ? v : byte_swap( v );
+		}
+
+		template <typename T, Byte_order O>
+		inline void store( uint8_t *p, T v )
+		{
+			v = O == HOST ? v : byte_swap( v );
+			__builtin_memcpy( p, &v, sizeof( T ) );
+		}
+
+		/// Longest encoding of a 64 bit varint
+		static const size_t MAX_VARINT = 10;
+
+		inline uint64_t zigzag( const int64_t v )
+		{
+			return ( uint64_t( v ) << 1 ) ^ uint64_t( v >> 63 );
+		}
+
+		inline int64_t unzigzag( const uint64_t v )
+		{
+			return int64_t( v >> 1 ) ^ -int64_t( v & 1 );
+		}
+	}
+
+	///
+	/// Read cursor without range checks, made by Reader::fixed() after
+	/// it checked the range once. Only cslassert checks the reads.
+	///
+	class Unchecked_reader
+	{
+		private:
+			const uint8_t *_p;
+			const uint8_t *const _end;
+
+			template <typename T, Byte_order O>
+			T _get()
+			{
+				cslassert( _p + sizeof( T ) <= _end );
+				T v = Codec::load<T, O>( _p );
+				_p += sizeof( T );
+				return v;
+			}
+
+		public:
+			Unchecked_reader( const uint8_t *p, const size_t size ): _p( p ), _end( p + size ) {}
+
+			uint8_t  get_u8()     { return _get<uint8_t,  Byte_order::big>(); }
+			uint16_t get_u16be()  { return _get<uint16_t, Byte_order::big>(); }
+			uint16_t get_u16le()  { return _get<uint16_t, Byte_order::little>(); }
+			uint32_t get_u32be()  { return _get<uint32_t, Byte_order::big>(); }
+			uint32_t get_u32le()  { return _get<uint32_t, Byte_order::little>(); }
+			uint64_t get_u64be()  { return _get<uint64_t, Byte_order::big>(); }
+			uint64_t get_u64le()  { return _get<uint64_t, Byte_order::little>(); }
+
+			/// \return the next size bytes, without copying them.
+			Data_descriptor get_bytes( const size_t size )
+			{
+				cslassert( _p + size <= _end );
+				Data_descriptor d( _p, size );
+				_p += size;
+				return d;
+			}
+
+			/// Copy the next target.size() bytes to target.
+			void get( const Data_descriptor_mod &target )
+			{
+				cslassert( _p + target.size() <= _end );
+				Genode::memcpy( target.data(), _p, target.size() );
+				_p += target.size();
+			}
+
+			void skip( const size_t size )
+			{
+				cslassert( _p + size <= _end );
+				_p += size;
+			}
+	};
+
+	///
+	/// Read cursor over a Data_descriptor, for parsing wire formats.
+	///
+	/// Every read checks the range and throws Out_of_range when the data
+	/// is exhausted. Fixed layouts check once with fixed(), which
+	/// returns an Unchecked_reader for the fields:
+	///
+	/// \verbatim
+	///
+	/// Csl::Reader r( packet );
+	/// Csl::Unchecked_reader udp = r.fixed( 8 );    // one check
+	/// uint16_t sport = udp.get_u16be();
+	/// uint16_t dport = udp.get_u16be();
+	/// uint16_t len   = udp.get_u16be();
+	/// udp.skip( 2 );                                // checksum
+	/// Csl::Data_descriptor payload = r.get_bytes( len - 8 );
+	///
+	/// \endverbatim
+	///
+	class Reader
+	{
+		private:
+			const uint8_t *_begin;
+			const uint8_t *_p;
+			const uint8_t *_end;
+
+			void _underflow( size_t size ) const __attribute__( ( noreturn, cold ) );
+
+			void _need( const size_t size ) const
+			{
+				if ( __builtin_expect( size > size_t( _end - _p ), false ) )
+				{
+					_underflow( size );
+				}
+			}
+
+			uint64_t _get_varint_checked();
+
+		public:
+			explicit Reader( const Data_descriptor &data ):
+				_begin( data.data() ), _p( _begin ), _end( _begin + data.size() ) {}
+
+			/// \return the bytes read so far
+			size_t position() const
+			{
+				return _p - _begin;
+			}
+
+			/// \return the bytes left to read
+			size_t left() const
+			{
+				return _end - _p;
+			}
+
+			bool at_end() const
+			{
+				return _p == _end;
+			}
+
+			/// Check that size bytes are left once, and advance past
+			/// them.
+			///
+			/// \return a cursor to read the size bytes without checks.
+			///
+			/// \throw Out_of_range when less than size bytes are left.
+			///
+			Unchecked_reader fixed( const size_t size )
+			{
+				_need( size );
+				Unchecked_reader r( _p, size );
+				_p += size;
+				return r;
+			}
+
+			uint8_t  get_u8()     { return fixed( 1 ).get_u8(); }
+			uint16_t get_u16be()  { return fixed( 2 ).get_u16be(); }
+			uint16_t get_u16le()  { return fixed( 2 ).get_u16le(); }
+			uint32_t get_u32be()  { return fixed( 4 ).get_u32be(); }
+			uint32_t get_u32le()  { return fixed( 4 ).get_u32le(); }
+			uint64_t get_u64be()  { return fixed( 8 ).get_u64be(); }
+			uint64_t get_u64le()  { return fixed( 8 ).get_u64le(); }
+
+			/// \return a LEB128 encoded unsigned integer.
+			///
+			/// \throw Out_of_range when the data ends in the varint, or the
+			///        varint exceeds 64 bits.
+			///
+			uint64_t get_varint()
+			{
+				if ( size_t( _end - _p ) < Codec::MAX_VARINT )
+				{
+					return _get_varint_checked();
+				}
+
+				uint64_t v = 0;
+
+				for ( unsigned shift = 0; shift < 64; shift += 7 )
+				{
+					const uint8_t b = *_p++;
+
+					// the 10th byte holds only bit 63
+					if ( 63 == shift && b > 1 )
+					{
+						throw Out_of_range( "Varint exceeds 64 bits" );
+					}
+
+					v |= uint64_t( b & 0x7f ) << shift;
+
+					if ( 0 == ( b & 0x80 ) )
+					{
+						return v;
+					}
+				}
+
+				throw Out_of_range( "Varint exceeds 64 bits" );
+			}
+
+			/// \return a zigzag and LEB128 encoded signed integer.
+			int64_t get_svarint()
+			{
+				return Codec::unzigzag( get_varint() );
+			}
+
+			/// \return the next size bytes, without copying them.
+			Data_descriptor get_bytes( const size_t size )
+			{
+				return fixed( size ).get_bytes( size );
+			}
+
+			/// Copy the next target.size() bytes to target.
+			void get( const Data_descriptor_mod &target )
+			{
+				fixed( target.size() ).get( target );
+			}
+
+			void skip( const size_t size )
+			{
+				fixed( size );
+			}
+
+			/// \return the bytes left to read, without advancing.
+			Data_descriptor rest() const
+			{
+				return Data_descriptor( _p, left() );
+			}
+	};
+
+	///
+	/// Write cursor without range checks, made by Writer::fixed().
+	///
+	class Unchecked_writer
+	{
+		private:
+			uint8_t *_p;
+			uint8_t *const _end;
+
+			template <typename T, Byte_order O>
+			void _put( const T v )
+			{
+				cslassert( _p + sizeof( T ) <= _end );
+				Codec::store<T, O>( _p, v );
+				_p += sizeof( T );
+			}
+
+		public:
+			Unchecked_writer( uint8_t *p, const size_t size ): _p( p ), _end( p + size ) {}
+
+			void put_u8( const uint8_t v )     { _put<uint8_t,  Byte_order::big>( v ); }
+			void put_u16be( const uint16_t v ) { _put<uint16_t, Byte_order::big>( v ); }
+			void put_u16le( const uint16_t v ) { _put<uint16_t, Byte_order::little>( v ); }
+			void put_u32be( const uint32_t v ) { _put<uint32_t, Byte_order::big>( v ); }
+			void put_u32le( const uint32_t v ) { _put<uint32_t, Byte_order::little>( v ); }
+			void put_u64be( const uint64_t v ) { _put<uint64_t, Byte_order::big>( v ); }
+			void put_u64le( const uint64_t v ) { _put<uint64_t, Byte_order::little>( v ); }
+
+			/// Copy the data subject to source.
+			void put( const Data_descriptor &source )
+			{
+				cslassert( _p + source.size() <= _end );
+				Genode::memcpy( _p, source.data(), source.size() );
+				_p += source.size();
+			}
+
+			/// Write size zero bytes.
+			void pad( const size_t size )
+			{
+				cslassert( _p + size <= _end );
+				Genode::memset( _p, 0, size );
+				_p += size;
+			}
+	};
+
+	///
+	/// Write cursor over a Data_descriptor_mod, the counterpart of
+	/// Reader. Writes throw Out_of_range when the memory is exhausted,
+	/// fixed() checks once for a batch of fields.
+	///
+	class Writer
+	{
+		private:
+			uint8_t *_begin;
+			uint8_t *_p;
+			uint8_t *_end;
+
+			void _overflow( size_t size ) const __attribute__( ( noreturn, cold ) );
+
+			void _need( const size_t size ) const
+			{
+				if ( __builtin_expect( size > size_t( _end - _p ), false ) )
+				{
+					_overflow( size );
+				}
+			}
+
+		public:
+			explicit Writer( const Data_descriptor_mod &target ):
+				_begin( target.data() ), _p( _begin ), _end( _begin + target.size() ) {}
+
+			/// \return the bytes written so far
+			size_t position() const
+			{
+				return _p - _begin;
+			}
+
+			/// \return the bytes left to write
+			size_t left() const
+			{
+				return _end - _p;
+			}
+
+			/// Check that size bytes are left once, and advance past
+			/// them.
+			///
+			/// \return a cursor to write the size bytes without checks.
+			///
+			/// \throw Out_of_range when less than size bytes are left.
+			///
+			Unchecked_writer fixed( const size_t size )
+			{
+				_need( size );
+				Unchecked_writer w( _p, size );
+				_p += size;
+				return w;
+			}
+
+			void put_u8( const uint8_t v )     { fixed( 1 ).put_u8( v ); }
+			void put_u16be( const uint16_t v ) { fixed( 2 ).put_u16be( v ); }
+			void put_u16le( const uint16_t v ) { fixed( 2 ).put_u16le( v ); }
+			void put_u32be( const uint32_t v ) { fixed( 4 ).put_u32be( v ); }
+			void put_u32le( const uint32_t v ) { fixed( 4 ).put_u32le( v ); }
+			void put_u64be( const uint64_t v ) { fixed( 8 ).put_u64be( v ); }
+			void put_u64le( const uint64_t v ) { fixed( 8 ).put_u64le( v ); }
+
+			/// Write v LEB128 encoded.
+			void put_varint( uint64_t v )
+			{
+				if ( size_t( _end - _p ) < Codec::MAX_VARINT )
+				{
+					size_t size = 1;
+
+					for ( uint64_t r = v >> 7; 0 != r; r >>= 7 )
+					{
+						++size;
+					}
+
+					_need( size );
+				}
+
+				while ( v >= 0x80 )
+				{
+					*_p++ = uint8_t( v ) | 0x80;
+					v >>= 7;
+				}
+
+				*_p++ = uint8_t( v );
+			}
+
+			/// Write v zigzag and LEB128 encoded.
+			void put_svarint( const int64_t v )
+			{
+				put_varint( Codec::zigzag( v ) );
+			}
+
+			/// Copy the data subject to source.
+			void put( const Data_descriptor &source )
+			{
+				fixed( source.size() ).put( source );
+			}
+
+			/// Write size zero bytes.
+			void pad( const size_t size )
+			{
+				fixed( size ).pad( size );
+			}
+
+			/// Advance past size bytes, to be written by the caller.
+			///
+			/// \return the size bytes.
+			///
+			/// \throw Out_of_range when less than size bytes are left.
+			///
+			Data_descriptor_mod reserve( const size_t size )
+			{
+				_need( size );
+				Data_descriptor_mod d( _p, size );
+				_p += size;
+				return d;
+			}
+
+			/// \return the bytes written.
+			Data_descriptor written() const
+			{
+				return Data_descriptor( _begin, position() );
+			}
+
+			/// \return the memory left to write.
+			Data_descriptor_mod rest() const
+			{
+				return Data_descriptor_mod( _p, left() );
+			}
+	};
+} // namespace Csl
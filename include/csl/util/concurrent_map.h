@@ -0,0 +1,388 @@
+///
+/// \file       concurrent_map.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Hash map with lock striping
+///
+
+#pragma once
+
+#include <csl/util/hash.h>
+#include <csl/util/rw_lock.h>
+#include <csl/util/atomic.h>
+
+namespace Csl
+{
+	///
+	/// Hash map that can be used by multiple threads at once.
+	///
+	/// The buckets are divided over STRIPES reader-writer locks. Lookups
+	/// take their stripe shared, modifications take it exclusively, so
+	/// threads working on keys in different stripes run in parallel, and
+	/// lookups never block each other. The table doubles when it holds
+	/// more than two entries per bucket; growing locks all stripes.
+	///
+	/// Values are handed out by copy (find) or to a handler that runs
+	/// under the stripe lock (read, update). References to values never
+	/// escape the lock.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Concurrent_map<Spi, Sa> _sas;
+	/// _sas.insert( spi, sa );
+	/// _sas.read( spi, [&]( const Sa &sa ) { sa.decrypt( packet ); } );
+	/// _sas.update( spi, [&]( Sa &sa ) { sa.replay_window.update( seq ); } );
+	///
+	/// \endverbatim
+	///
+	/// \param KEY      key type, compared with ==.
+	/// \param VALUE    value type, copy constructible.
+	/// \param HASH     hash function object for keys.
+	/// \param STRIPES  number of locks, a power of two.
+	///
+	template <typename KEY, typename VALUE, typename HASH = hash<KEY>, size_t STRIPES = 16>
+	class Concurrent_map
+	{
+		private:
+			static_assert( STRIPES && !( STRIPES & ( STRIPES - 1 ) ),
+			               "STRIPES must be a power of two" );
+
+			struct Node
+			{
+				const KEY key;
+				VALUE value;
+				Node *next;
+
+				Node( const KEY &key, const VALUE &value, Node *next ):
+					key( key ), value( value ), next( next ) {}
+			};
+
+			HASH _hash;
+			mutable Rw_lock _stripes[STRIPES];
+			Node **_buckets;
+			size_t _bucket_count;
+			Atomic_variable<size_t> _size;
+
+			Concurrent_map( const Concurrent_map & );
+			Concurrent_map &operator=( const Concurrent_map & );
+
+			/// Hash key, and spread the bits of the hash: Csl::hash
+			/// leaves the low bits of small keys poorly distributed.
+			size_t _hashed( const KEY &key ) const
+			{
+				size_t h = _hash( key );
+				h ^= h >> 15;
+				h *= 0x2c1b3c6dUL;
+				h ^= h >> 12;
+				return h;
+			}
+
+			// The stripe only depends on the low bits of the hash, which
+			// don't change when the table grows, since _bucket_count is a
+			// power of two and at least STRIPES.
+			Rw_lock &_stripe( const size_t h ) const
+			{
+				return _stripes[h & ( STRIPES - 1 )];
+			}
+
+			/// \pre the stripe of h is locked
+			Node **_bucket( const size_t h ) const
+			{
+				return &_buckets[h & ( _bucket_count - 1 )];
+			}
+
+			/// \pre the stripe of h is locked
+			Node *_find( const size_t h, const KEY &key ) const
+			{
+				for ( Node *n = *_bucket( h ); n; n = n->next )
+				{
+					if ( n->key == key )
+					{
+						return n;
+					}
+				}
+
+				return nullptr;
+			}
+
+			void _lock_all()
+			{
+				for ( size_t i = 0; i < STRIPES; ++i )
+				{
+					_stripes[i].lock();
+				}
+			}
+
+			void _unlock_all()
+			{
+				for ( size_t i = STRIPES; i > 0; --i )
+				{
+					_stripes[i - 1].unlock();
+				}
+			}
+
+			void _grow_if_loaded( const size_t seen_buckets )
+			{
+				if ( _size.load( Memory_order::relaxed ) <= 2 * seen_buckets )
+				{
+					return;
+				}
+
+				_lock_all();
+
+				// Somebody else may have grown the table meanwhile
+				if ( _bucket_count == seen_buckets )
+				{
+					const size_t count = _bucket_count * 2;
+					Node **buckets = new Node *[count]();
+
+					for ( size_t i = 0; i < _bucket_count; ++i )
+					{
+						for ( Node *n = _buckets[i]; n; )
+						{
+							Node *next = n->next;
+							Node **b = &buckets[_hashed( n->key ) & ( count - 1 )];
+							n->next = *b;
+							*b = n;
+							n = next;
+						}
+					}
+
+					delete[] _buckets;
+					_buckets = buckets;
+					_bucket_count = count;
+				}
+
+				_unlock_all();
+			}
+
+			static size_t _initial_buckets( const size_t buckets )
+			{
+				size_t count = STRIPES;
+
+				while ( count < buckets )
+				{
+					count *= 2;
+				}
+
+				return count;
+			}
+
+			template <typename FUN>
+			bool _insert( const KEY &key, const VALUE &value, FUN const &exists )
+			{
+				const size_t h = _hashed( key );
+				size_t seen_buckets = 0;
+				bool inserted = false;
+
+				{
+					Rw_lock::Write_guard guard( _stripe( h ) );
+					seen_buckets = _bucket_count;
+					Node *n = _find( h, key );
+
+					if ( nullptr != n )
+					{
+						exists( n->value );
+					}
+					else
+					{
+						Node **b = _bucket( h );
+						*b = new Node( key, value, *b );
+						_size.fetch_add( 1 );
+						inserted = true;
+					}
+				}
+
+				if ( inserted )
+				{
+					_grow_if_loaded( seen_buckets );
+				}
+
+				return inserted;
+			}
+
+		public:
+			/// Constructor
+			///
+			/// \param buckets  initial number of buckets, rounded up to a
+			///                 power of two of at least STRIPES.
+			///
+			explicit Concurrent_map( const size_t buckets = 64 ):
+				_buckets( new Node *[_initial_buckets( buckets )]() ),
+				_bucket_count( _initial_buckets( buckets ) ),
+				_size( size_t( 0 ) )
+			{}
+
+			~Concurrent_map()
+			{
+				clear();
+				delete[] _buckets;
+			}
+
+			/// Insert key, unless it is present already.
+			///
+			/// \return false iff key was present, its value is unchanged.
+			///
+			bool insert( const KEY &key, const VALUE &value )
+			{
+				return _insert( key, value, []( VALUE & ) {} );
+			}
+
+			/// Insert key, or replace the value of key.
+			///
+			/// \return true iff key was inserted.
+			///
+			bool assign( const KEY &key, const VALUE &value )
+			{
+				return _insert( key, value, [&]( VALUE &v )
+				{
+					v = value;
+				} );
+			}
+
+			/// Look up key.
+			///
+			/// \param value  receives a copy of the value.
+			///
+			/// \return false iff key is not present.
+			///
+			bool find( const KEY &key, VALUE &value ) const
+			{
+				const size_t h = _hashed( key );
+				Rw_lock::Read_guard guard( _stripe( h ) );
+				const Node *n = _find( h, key );
+
+				if ( nullptr == n )
+				{
+					return false;
+				}
+
+				value = n->value;
+				return true;
+			}
+
+			bool contains( const KEY &key ) const
+			{
+				const size_t h = _hashed( key );
+				Rw_lock::Read_guard guard( _stripe( h ) );
+				return nullptr != _find( h, key );
+			}
+
+			/// Call handle( const VALUE & ) on the value of key, with its
+			/// stripe locked shared.
+			///
+			/// \return false iff key is not present.
+			///
+			template<typename FUN>
+			bool read( const KEY &key, FUN handle ) const
+			{
+				const size_t h = _hashed( key );
+				Rw_lock::Read_guard guard( _stripe( h ) );
+				const Node *n = _find( h, key );
+
+				if ( nullptr == n )
+				{
+					return false;
+				}
+
+				handle( n->value );
+				return true;
+			}
+
+			/// Call handle( VALUE & ) on the value of key, with its stripe
+			/// locked exclusively.
+			///
+			/// \return false iff key is not present.
+			///
+			template<typename FUN>
+			bool update( const KEY &key, FUN handle )
+			{
+				const size_t h = _hashed( key );
+				Rw_lock::Write_guard guard( _stripe( h ) );
+				Node *n = _find( h, key );
+
+				if ( nullptr == n )
+				{
+					return false;
+				}
+
+				handle( n->value );
+				return true;
+			}
+
+			/// \return false iff key was not present.
+			bool erase( const KEY &key )
+			{
+				const size_t h = _hashed( key );
+				Rw_lock::Write_guard guard( _stripe( h ) );
+
+				for ( Node **p = _bucket( h ); *p; p = &( *p )->next )
+				{
+					if ( ( *p )->key == key )
+					{
+						Node *n = *p;
+						*p = n->next;
+						delete n;
+						_size.fetch_sub( 1 );
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			/// Call handle( const KEY &, const VALUE & ) for every entry.
+			/// Stripes are locked shared one at a time, so the walk is not
+			/// an atomic snapshot of the map.
+			template<typename FUN>
+			void for_each( FUN handle ) const
+			{
+				for ( size_t s = 0; s < STRIPES; ++s )
+				{
+					Rw_lock::Read_guard guard( _stripes[s] );
+
+					for ( size_t i = s; i < _bucket_count; i += STRIPES )
+					{
+						for ( const Node *n = _buckets[i]; n; n = n->next )
+						{
+							handle( n->key, const_cast<const VALUE &>( n->value ) );
+						}
+					}
+				}
+			}
+
+			void clear()
+			{
+				_lock_all();
+
+				for ( size_t i = 0; i < _bucket_count; ++i )
+				{
+					for ( Node *n = _buckets[i]; n; )
+					{
+						Node *next = n->next;
+						delete n;
+						n = next;
+					}
+
+					_buckets[i] = nullptr;
+				}
+
+				_size.store( 0 );
+				_unlock_all();
+			}
+
+			/// \return the number of entries, may be outdated as soon as
+			///         it is returned.
+			size_t size() const
+			{
+				return _size.load( Memory_order::relaxed );
+			}
+	};
+} // namespace Csl
@@ -374,6 +374,9 @@ namespace Csl
 		return Genode::memcmp( a.data(), b.data(), b.size() );
 	}
 
+	/// \return a Data_descriptor to the in-memory representation of
+	///         serializable, including padding and in host byte order. For
+	///         wire formats describe the struct with CSL_FIELDS (fields.h).
 	template<typename SERIALIZABLE>
 	inline Csl::Data_descriptor to_data_descriptor( const SERIALIZABLE
 	        &serializable )
@@ -339,16 +339,6 @@ namespace Csl
 					Genode::Attached_rom_dataspace _dataspace;
 
 					Signal_queue *_queue;
-
-					/// 1) Wait for signal(s) to come in
-					/// 2) Retrieve the new dataspace.
-					/// 3) Reset local data structures in order to start processing the data.
-					void _wait_and_update_data()
-					{
-						_receiver.wait_for_signal();
-						_dataspace.update();
-						_queue = _dataspace.local_addr<Signal_queue>();
-					}
 				public:
 					///
 					/// Constructor
@@ -363,6 +353,24 @@ namespace Csl
 						_dataspace.sigh( _sig_capability );
 					}
 
+					///
+					/// Constructor for receivers that are dispatched by an
+					/// entrypoint, e.g. by a Csl::Reactor, instead of by a
+					/// thread that blocks in wait_and_handle().
+					///
+					/// \param sigh signal handler that calls handle_pending()
+					/// \param id   name of the descriptive signal
+					///
+					Receiver( Genode::Signal_context_capability sigh, const char *id ):
+						_receiver(),
+						_context(),
+						_sig_capability( sigh ),
+						_dataspace( id ),
+						_queue( _dataspace.local_addr<Signal_queue>() )
+					{
+						_dataspace.sigh( _sig_capability );
+					}
+
 					virtual ~Receiver() {}
 
 					/// Wait and unblock whenever a signal comes in. Call handler to process the signal.
@@ -372,7 +380,31 @@ namespace Csl
 					template <typename FUN>
 					void wait_and_handle( FUN handler )
 					{
-						_wait_and_update_data();
+						_receiver.wait_for_signal();
+						handle_pending( handler );
+					}
+
+					/// Call handler for the signals that came in, without
+					/// blocking. Call it from the signal handler passed to the
+					/// constructor.
+					///
+					/// Example:
+					/// \verbatim
+					///
+					/// Key_expiration_signal::Receiver *receiver;
+					/// receiver = new Key_expiration_signal::Receiver(
+					///   reactor.on_signal( [&]() { receiver->handle_pending( regenerate ); } ),
+					///   "descriptive_signal" );
+					///
+					/// \endverbatim
+					///
+					/// \param handler handler accepting a T argument for processing.
+					///
+					template <typename FUN>
+					void handle_pending( FUN handler )
+					{
+						_dataspace.update();
+						_queue = _dataspace.local_addr<Signal_queue>();
 
 						for ( Csl::size_t i = 0 ; i < _queue->size(); ++i ) // .. and handle
 						{
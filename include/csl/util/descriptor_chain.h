@@ -0,0 +1,419 @@
+///
+/// \file       descriptor_chain.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Scatter-gather lists of Data_descriptors
+///
+
+#pragma once
+
+#include <csl/util/stdint.h>
+#include <csl/util/exception.h>
+#include <csl/util/data_descriptor.h>
+
+namespace Csl
+{
+	///
+	/// Internet checksum (RFC 1071) over data that may be split at any
+	/// byte, as in the checksums of IP, UDP and TCP.
+	///
+	class Internet_checksum
+	{
+		private:
+			uint64_t _sum;
+			bool _odd;      // the last add() ended halfway a 16 bit word
+
+		public:
+			Internet_checksum(): _sum( 0 ), _odd( false ) {}
+
+			void add( const uint8_t *data, size_t size );
+
+			/// \return the checksum, in host byte order.
+			uint16_t value() const;
+	};
+
+	///
+	/// Chain of Data_descriptors that is handled as one sequence of
+	/// bytes, like an iovec array.
+	///
+	/// A message is assembled by appending its fragments, without
+	/// copying them. Small serialized items, such as headers, are
+	/// written with operator<< into scratch space inside the chain,
+	/// payloads are referenced. The chain doesn't own the fragments, they
+	/// must stay valid as long as the chain is used. A chain can't be
+	/// copied, because it references its own scratch space.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Descriptor_chain msg;
+	/// msg << esp_header << payload.dd() << trailer;
+	/// send( msg.flatten( _tx_buffer ) );    // only copies if fragmented
+	///
+	/// \endverbatim
+	///
+	template <class T>
+	class Descriptor_chain_template
+	{
+		public:
+			typedef Data_descriptor_template<T> Descriptor;
+
+			static const unsigned INLINE_FRAGMENTS = 8;
+			static const size_t SCRATCH_SIZE = 256;
+
+		private:
+			Descriptor _inline[INLINE_FRAGMENTS];
+			Descriptor *_fragments;
+			unsigned _count;
+			unsigned _capacity;
+			size_t _size;
+			uint8_t _scratch[SCRATCH_SIZE];
+			size_t _scratch_used;
+
+			Descriptor_chain_template( const Descriptor_chain_template & );
+			Descriptor_chain_template &operator=( const Descriptor_chain_template & );
+
+			void _grow()
+			{
+				Descriptor *fragments = new Descriptor[2 * _capacity];
+
+				for ( unsigned i = 0; i < _count; ++i )
+				{
+					fragments[i] = _fragments[i];
+				}
+
+				if ( _fragments != _inline )
+				{
+					delete[] _fragments;
+				}
+
+				_fragments = fragments;
+				_capacity *= 2;
+			}
+
+			/// Call f( fragment data, fragment size ) for the bytes from
+			/// offset on, until f returns false.
+			template <typename F>
+			void _walk( size_t offset, F f ) const
+			{
+				for ( unsigned i = 0; i < _count; ++i )
+				{
+					const size_t s = _fragments[i].size();
+
+					if ( offset >= s )
+					{
+						offset -= s;
+						continue;
+					}
+
+					if ( not f( _fragments[i].data() + offset, s - offset ) )
+					{
+						return;
+					}
+
+					offset = 0;
+				}
+			}
+
+		public:
+			Descriptor_chain_template():
+				_fragments( _inline ),
+				_count( 0 ),
+				_capacity( INLINE_FRAGMENTS ),
+				_size( 0 ),
+				_scratch_used( 0 )
+			{}
+
+			~Descriptor_chain_template()
+			{
+				if ( _fragments != _inline )
+				{
+					delete[] _fragments;
+				}
+			}
+
+			/// Append a fragment. It is merged with the last fragment iff
+			/// it directly follows it in memory.
+			void append( const Descriptor &d )
+			{
+				if ( not d.valid() || 0 == d.size() )
+				{
+					return;
+				}
+
+				if ( 0 != _count && _fragments[_count - 1].right_adjecent_to( d ) )
+				{
+					Descriptor &last = _fragments[_count - 1];
+					last = Descriptor( last.data(), last.size() + d.size() );
+				}
+				else
+				{
+					if ( _count == _capacity )
+					{
+						_grow();
+					}
+
+					_fragments[_count++] = d;
+				}
+
+				_size += d.size();
+			}
+
+			/// Insert a fragment in front of the chain.
+			void prepend( const Descriptor &d )
+			{
+				if ( not d.valid() || 0 == d.size() )
+				{
+					return;
+				}
+
+				if ( _count == _capacity )
+				{
+					_grow();
+				}
+
+				for ( unsigned i = _count; i > 0; --i )
+				{
+					_fragments[i] = _fragments[i - 1];
+				}
+
+				_fragments[0] = d;
+				++_count;
+				_size += d.size();
+			}
+
+			/// \return the unused scratch space, to serialize into.
+			Data_descriptor_mod scratch()
+			{
+				return Data_descriptor_mod( _scratch + _scratch_used, SCRATCH_SIZE - _scratch_used );
+			}
+
+			/// Append the first n bytes of scratch() to the chain.
+			///
+			/// \throw Out_of_range when n exceeds the scratch space.
+			///
+			void commit_scratch( const size_t n )
+			{
+				if ( n > SCRATCH_SIZE - _scratch_used )
+				{
+					throw Out_of_range( "Descriptor_chain scratch space exhausted" );
+				}
+
+				append( Descriptor( ( T ) ( _scratch + _scratch_used ), n ) );
+				_scratch_used += n;
+			}
+
+			/// Remove all fragments and release the scratch space.
+			void clear()
+			{
+				_count = 0;
+				_size = 0;
+				_scratch_used = 0;
+			}
+
+			/// \return the total size of the fragments
+			size_t size() const
+			{
+				return _size;
+			}
+
+			unsigned count() const
+			{
+				return _count;
+			}
+
+			const Descriptor &fragment( const unsigned i ) const
+			{
+				cslassert( i < _count );
+				return _fragments[i];
+			}
+
+			/// Call f( const Descriptor & ) for every fragment.
+			template <typename F>
+			void for_each( F f ) const
+			{
+				for ( unsigned i = 0; i < _count; ++i )
+				{
+					f( _fragments[i] );
+				}
+			}
+
+			/// Gather bytes of the chain.
+			///
+			/// \param target  memory to copy to.
+			/// \param offset  offset in the chain to start at.
+			///
+			/// \return the number of bytes copied.
+			///
+			size_t copy_out( const Data_descriptor_mod &target, const size_t offset = 0 ) const
+			{
+				uint8_t *dst = target.data();
+				size_t left = target.size();
+
+				_walk( offset, [&]( T p, size_t s )
+				{
+					s = s < left ? s : left;
+					Genode::memcpy( dst, p, s );
+					dst += s;
+					left -= s;
+					return 0 != left;
+				} );
+
+				return target.size() - left;
+			}
+
+			/// Scatter bytes into the chain, only for chains of
+			/// writable fragments.
+			///
+			/// \param source  memory to copy from.
+			/// \param offset  offset in the chain to start at.
+			///
+			/// \return the number of bytes copied.
+			///
+			size_t copy_in( const Data_descriptor &source, const size_t offset = 0 ) const
+			{
+				const uint8_t *src = source.data();
+				size_t left = source.size();
+
+				_walk( offset, [&]( T p, size_t s )
+				{
+					s = s < left ? s : left;
+					Genode::memcpy( p, src, s );
+					src += s;
+					left -= s;
+					return 0 != left;
+				} );
+
+				return source.size() - left;
+			}
+
+			/// \return the Internet checksum of the whole chain.
+			uint16_t checksum() const
+			{
+				Internet_checksum sum;
+
+				for ( unsigned i = 0; i < _count; ++i )
+				{
+					sum.add( ( const uint8_t * ) _fragments[i].data(), _fragments[i].size() );
+				}
+
+				return sum.value();
+			}
+
+			/// Make the chain contiguous.
+			///
+			/// \param target  memory to gather the fragments in.
+			///
+			/// \return the single fragment of a chain of one fragment,
+			///         without copying, or else the part of target the
+			///         chain was copied to.
+			///
+			/// \throw Out_of_range when the chain doesn't fit target.
+			///
+			Data_descriptor flatten( const Data_descriptor_mod &target ) const
+			{
+				if ( 1 == _count )
+				{
+					return Data_descriptor( ( const uint8_t * ) _fragments[0].data(),
+					                        _fragments[0].size() );
+				}
+
+				if ( target.size() < _size )
+				{
+					throw Out_of_range( "Descriptor_chain doesn't fit the target" );
+				}
+
+				copy_out( target );
+				return Data_descriptor( target.data(), _size );
+			}
+
+			/// \return a copy of the chain in one string.
+			operator ustring() const
+			{
+				ustring s;
+
+				for ( unsigned i = 0; i < _count; ++i )
+				{
+					s.append( ( const uint8_t * ) _fragments[i].data(), _fragments[i].size() );
+				}
+
+				return s;
+			}
+	};
+
+	/// Chain of read-only fragments, to assemble messages.
+	typedef Descriptor_chain_template<const uint8_t *> Descriptor_chain;
+
+	/// Chain of writable fragments, to scatter received data.
+	typedef Descriptor_chain_template<uint8_t *> Descriptor_chain_mod;
+
+	/// Gather the data subject to the source chain into target.
+	///
+	/// \pre source must fit into target.
+	///
+	template<class T>
+	void memcpy( const Data_descriptor_mod &target,
+	             const Descriptor_chain_template<T> &source )
+	{
+		cslassert( target.valid() );
+		cslassert( target.size() >= source.size() );
+		source.copy_out( target );
+	}
+
+	/// Scatter the data subject to source over the target chain.
+	///
+	/// \pre source must fit into target.
+	///
+	template<class T>
+	void memcpy( const Descriptor_chain_mod &target,
+	             const Data_descriptor_template<T> &source )
+	{
+		cslassert( source.valid() );
+		cslassert( target.size() >= source.size() );
+		target.copy_in( Data_descriptor( ( const uint8_t * ) source.data(), source.size() ) );
+	}
+}
+
+/// Stream operator overload to append a Data_descriptor to a chain,
+/// without copying the data.
+///
+/// \param c  chain to append to.
+/// \param d  Data_descriptor that represents the data to append.
+///
+/// \return c.
+///
+template <class T, class U>
+inline Csl::Descriptor_chain_template<T> &operator<<( Csl::Descriptor_chain_template<T> &c,
+        Csl::Data_descriptor_template<U> d )
+{
+	if ( d.valid() )
+	{
+		c.append( Csl::Data_descriptor_template<T>( d.data(), d.size() ) );
+	}
+
+	return c;
+}
+
+/// Stream operator overload to serialize a serializable class into the
+/// scratch space of a chain.
+///
+/// \param c             chain to append to.
+/// \param serializable  an instance of a serializable class.
+///
+/// \return c.
+///
+template <class T, class S>
+inline Csl::Descriptor_chain_template<T> &operator<<( Csl::Descriptor_chain_template<T> &c,
+        const S &serializable )
+{
+	Csl::Data_descriptor_mod room = c.scratch();
+	Csl::Data_descriptor_mod rest = room << serializable;
+	c.commit_scratch( room.size() - rest.size() );
+	return c;
+}
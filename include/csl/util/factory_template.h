@@ -13,6 +13,12 @@
 
 #pragma once
 
+///
+/// Creates the type out of Ts whose PLT equals id, from a data
+/// descriptor. Payloads are created per packet: derive them from
+/// Csl::Pool_allocated (csl/util/object_pool.h) so create() takes them
+/// from the slab size classes, and deleting them frees them sized.
+///
 template <typename B, typename... Ts>
 struct Factory_template
 {
@@ -0,0 +1,256 @@
+///
+/// \file       fields.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Serializers generated from a description of the fields
+///
+
+#pragma once
+
+#include <csl/util/stdint.h>
+#include <csl/util/exception.h>
+#include <csl/util/type_traits.h>
+#include <csl/util/data_descriptor.h>
+#include <csl/util/codec.h>
+
+namespace Csl
+{
+	template <size_t SIZE> struct Uint_of_size;
+	template <> struct Uint_of_size<1> { using Type = uint8_t; };
+	template <> struct Uint_of_size<2> { using Type = uint16_t; };
+	template <> struct Uint_of_size<4> { using Type = uint32_t; };
+	template <> struct Uint_of_size<8> { using Type = uint64_t; };
+
+	///
+	/// Wire format of a value of type T: SIZE bytes in byte order O.
+	///
+	/// By default T is a struct described with CSL_FIELDS, there are
+	/// specializations for integers, enums and arrays.
+	///
+	template <typename T, Byte_order O, typename ENABLE = void>
+	struct Wire_format
+	{
+		static constexpr size_t SIZE = T::Fields::SIZE;
+
+		static void store( uint8_t *p, const T &v ) { T::Fields::store( p, v ); }
+		static void load( const uint8_t *p, T &v )  { T::Fields::load( p, v ); }
+	};
+
+	template <typename T, Byte_order O>
+	struct Wire_format<T, O, typename Enable_if<Is_integral<T>::VALUE || Is_enum<T>::VALUE>::Type>
+	{
+		typedef typename Uint_of_size<sizeof( T )>::Type Uint;
+
+		static constexpr size_t SIZE = sizeof( T );
+
+		static void store( uint8_t *p, const T &v )
+		{
+			Codec::store<Uint, O>( p, static_cast<Uint>( v ) );
+		}
+
+		static void load( const uint8_t *p, T &v )
+		{
+			v = static_cast<T>( Codec::load<Uint, O>( p ) );
+		}
+	};
+
+	template <typename T, size_t N, Byte_order O>
+	struct Wire_format<T[N], O>
+	{
+		static constexpr size_t SIZE = N * Wire_format<T, O>::SIZE;
+
+		static void store( uint8_t *p, const T ( &v )[N] )
+		{
+			for ( size_t i = 0; i < N; ++i )
+			{
+				Wire_format<T, O>::store( p + i * Wire_format<T, O>::SIZE, v[i] );
+			}
+		}
+
+		static void load( const uint8_t *p, T ( &v )[N] )
+		{
+			for ( size_t i = 0; i < N; ++i )
+			{
+				Wire_format<T, O>::load( p + i * Wire_format<T, O>::SIZE, v[i] );
+			}
+		}
+	};
+
+	///
+	/// Member M of T, in byte order O on the wire. Use the CSL_FIELD
+	/// macros instead of naming it.
+	///
+	template <typename T, typename M, M T::*MEMBER, Byte_order O = Byte_order::big>
+	struct Field
+	{
+		static constexpr size_t SIZE = Wire_format<M, O>::SIZE;
+
+		static void store( uint8_t *p, const T &v ) { Wire_format<M, O>::store( p, v.*MEMBER ); }
+		static void load( const uint8_t *p, T &v )  { Wire_format<M, O>::load( p, v.*MEMBER ); }
+	};
+
+	///
+	/// N reserved bytes, written as zeroes and skipped when loading.
+	///
+	template <size_t N>
+	struct Pad
+	{
+		static constexpr size_t SIZE = N;
+
+		template <typename T>
+		static void store( uint8_t *p, const T & ) { Genode::memset( p, 0, N ); }
+
+		template <typename T>
+		static void load( const uint8_t *, T & ) {}
+	};
+
+	///
+	/// Wire layout of a struct: the FIELDS in order, without padding.
+	///
+	/// SIZE is known at compile time, and store() and load() unroll to
+	/// straight-line code with constant offsets. The range is checked
+	/// once per struct, not per field.
+	///
+	template <typename ...FIELDS>
+	struct Field_list;
+
+	template <>
+	struct Field_list<>
+	{
+		static constexpr size_t SIZE = 0;
+
+		template <typename T>
+		static void store( uint8_t *, const T & ) {}
+
+		template <typename T>
+		static void load( const uint8_t *, T & ) {}
+	};
+
+	template <typename FIELD, typename ...REST>
+	struct Field_list<FIELD, REST...>
+	{
+		static constexpr size_t SIZE = FIELD::SIZE + Field_list<REST...>::SIZE;
+
+		/// Write v to SIZE bytes at p, without checks.
+		template <typename T>
+		static void store( uint8_t *p, const T &v )
+		{
+			FIELD::store( p, v );
+			Field_list<REST...>::store( p + FIELD::SIZE, v );
+		}
+
+		/// Read v from SIZE bytes at p, without checks.
+		template <typename T>
+		static void load( const uint8_t *p, T &v )
+		{
+			FIELD::load( p, v );
+			Field_list<REST...>::load( p + FIELD::SIZE, v );
+		}
+
+		/// Write v to d, d must hold at least SIZE bytes.
+		///
+		/// \return the rest of d.
+		///
+		template <typename T>
+		static Data_descriptor_mod serialize( const Data_descriptor_mod &d, const T &v )
+		{
+			cslassert( d.size() >= SIZE );
+			store( d.data(), v );
+			return d.advance( SIZE );
+		}
+
+		/// Read v from d.
+		///
+		/// \return the rest of d.
+		///
+		/// \throw Out_of_range when d holds less than SIZE bytes.
+		///
+		template <typename T>
+		static Data_descriptor deserialize( const Data_descriptor &d, T &v )
+		{
+			if ( d.size() < SIZE )
+			{
+				throw Out_of_range( "Data too short for fixed layout" );
+			}
+
+			load( d.data(), v );
+			return d.advance( SIZE );
+		}
+
+		template <typename T>
+		static void write( Writer &w, const T &v )
+		{
+			store( w.reserve( SIZE ).data(), v );
+		}
+
+		template <typename T>
+		static void read( Reader &r, T &v )
+		{
+			load( r.get_bytes( SIZE ).data(), v );
+		}
+	};
+}
+
+/// Describe member m of struct T, big endian on the wire.
+#define CSL_FIELD( T, m ) Csl::Field<T, decltype( T::m ), &T::m>
+
+/// Describe member m of struct T, little endian on the wire.
+#define CSL_FIELD_LE( T, m ) Csl::Field<T, decltype( T::m ), &T::m, Csl::Byte_order::little>
+
+/// Describe n reserved bytes.
+#define CSL_PAD( n ) Csl::Pad<n>
+
+///
+/// Describe the wire layout of a struct, in the struct. It defines the
+/// Field_list Fields, and serialize() and deserialize(), so the struct
+/// works with operator<< and operator>>.
+///
+/// Example:
+/// \verbatim
+///
+/// struct Esp_header
+/// {
+///   uint32_t spi;
+///   uint32_t seq;
+///
+///   CSL_FIELDS( CSL_FIELD( Esp_header, spi ),
+///               CSL_FIELD( Esp_header, seq ) );
+/// };
+///
+/// static_assert( Esp_header::Fields::SIZE == 8, "ESP header is 8 bytes" );
+///
+/// Csl::Data_descriptor_mod rest = packet << header;
+/// Csl::Data_descriptor payload = received >> header;
+///
+/// \endverbatim
+///
+#define CSL_FIELDS( ... )                                                   \
+	typedef Csl::Field_list<__VA_ARGS__> Fields;                            \
+	Csl::Data_descriptor_mod serialize( const Csl::Data_descriptor_mod &d ) const \
+	{                                                                       \
+		return Fields::serialize( d, *this );                               \
+	}                                                                       \
+	Csl::Data_descriptor deserialize( const Csl::Data_descriptor &d )       \
+	{                                                                       \
+		return Fields::deserialize( d, *this );                             \
+	}
+
+/// Stream operator overload to deserialize a serializable class.
+///
+/// \param d            Memory to deserialize from.
+/// \param serializable An instance of a serializable class.
+///
+/// \return a Data_descriptor that represents the rest of d after
+/// deserialization.
+///
+template <class S>
+inline Csl::Data_descriptor operator>>( const Csl::Data_descriptor &d, S &serializable )
+{
+	return serializable.deserialize( d );
+}
@@ -13,7 +13,10 @@
 
 #pragma once
 
+#include <base/allocator.h>
+
 #include <csl/util/exception.h>
+#include <csl/util/object_pool.h>
 
 namespace Csl
 {
@@ -95,7 +98,7 @@ namespace Csl
 
 		private:
 
-			class Element
+			class Element: public Pool_allocated<Element>
 			{
 
 				private:
@@ -140,12 +143,38 @@ namespace Csl
 			Element *_head = nullptr;
 			Element *_tail = nullptr;
 			size_t   _size = 0;
+			Genode::Allocator *_alloc = nullptr;
+
+			Element *_new_element( T t )
+			{
+				if ( nullptr == _alloc )
+				{
+					return new Element( t );
+				}
+
+				return new ( _alloc ) Element( t );
+			}
+
+			void _delete_element( Element *e )
+			{
+				if ( nullptr == _alloc )
+				{
+					delete e;
+					return;
+				}
+
+				Genode::destroy( _alloc, e );
+			}
 
 		public:
 
 			// default constructor
 			List() {}
 
+			/// List with its elements allocated from alloc, such as an
+			/// Arena. Copies of the list use the heap.
+			explicit List( Genode::Allocator &alloc ): _alloc( &alloc ) {}
+
 			// copy constructor; makes a deep copy
 			List( const List<T> &other )
 			{
@@ -191,7 +220,7 @@ namespace Csl
 			void push_back( T t )
 			{
 				//			FLOG("push_back called" );
-				Element *e = new Element( t );
+				Element *e = _new_element( t );
 
 				//			FLOG(" new element created");
 				if ( _head == nullptr )
@@ -274,7 +303,7 @@ namespace Csl
 					_tail = _tail->prev();
 				}
 
-				delete i._i;
+				_delete_element( i._i );
 				_size--;
 			}
 
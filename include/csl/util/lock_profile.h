@@ -0,0 +1,320 @@
+///
+/// \file       lock_profile.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Lock contention profiling
+///
+
+#pragma once
+
+#include <base/lock.h>
+#include <base/lock_guard.h>
+#include <base/env.h>
+#include <trace/timestamp.h>
+
+///
+/// The locks of locked_object, Queue, Blocking_queue, the locked
+/// Atomic_variable and Shared_settings are Profiled_locks. Without
+/// CSL_LOCK_PROFILE a Profiled_lock is just a Genode::Lock and its name
+/// is discarded. With CSL_LOCK_PROFILE every Profiled_lock counts its
+/// acquisitions, and keeps a histogram of the time spent waiting for
+/// and holding the lock.
+///
+/// Profiled_lock is larger with CSL_LOCK_PROFILE, and it is embedded in
+/// templates that components instantiate. Define it only in
+/// lib/import/import-libcsl.mk, so libcsl and all its users are built
+/// with the same layout.
+///
+/// Example:
+/// \verbatim
+///
+/// Csl::Queue<Packet *> _rx;
+/// _rx.lock_name( "nic rx" );
+///
+/// // dump the profile of every lock in the component
+/// Csl::Lock_profile::for_each( [&]( const Csl::Lock_profile &p ) {
+///   Genode::log( p.name(), ": ", p.contended(), "/", p.acquisitions() );
+/// } );
+///
+/// // or report it every 5 seconds as "lock_profile"
+/// Csl::Lock_profile_reporter reporter( env, 5000 );
+///
+/// \endverbatim
+///
+
+namespace Csl
+{
+	///
+	/// Acquisition statistics of a single lock.
+	///
+	/// Times are in timestamp ticks (see Genode::Trace::timestamp).
+	/// Histogram bucket i counts the durations d with
+	/// 2^(i-1) <= d < 2^i, bucket 0 counts durations of 0.
+	///
+	class Lock_profile
+	{
+		public:
+			static const unsigned BUCKETS = 40;
+
+		private:
+			const char *_name;
+			unsigned long _acquisitions;
+			unsigned long _contended;
+			unsigned long _wait[BUCKETS];
+			unsigned long _hold[BUCKETS];
+			Lock_profile *_next;
+
+			// Written by the lock holder only
+			Genode::Trace::Timestamp _acquired_at;
+			bool _held;
+
+			friend class Profiled_lock;
+
+			Lock_profile( const Lock_profile & );
+			Lock_profile &operator=( const Lock_profile & );
+
+			static Genode::Lock &_registry_lock()
+			{
+				static Genode::Lock lock;
+				return lock;
+			}
+
+			static Lock_profile *&_registry()
+			{
+				static Lock_profile *head = nullptr;
+				return head;
+			}
+
+			static unsigned _bucket( Genode::Trace::Timestamp ticks )
+			{
+				unsigned b = 0;
+
+				for ( ; ticks && b < BUCKETS - 1; ticks >>= 1 )
+				{
+					++b;
+				}
+
+				return b;
+			}
+
+			static void _count( unsigned long &counter )
+			{
+				__atomic_fetch_add( &counter, 1UL, __ATOMIC_RELAXED );
+			}
+
+			static unsigned long _read( const unsigned long &counter )
+			{
+				return __atomic_load_n( &counter, __ATOMIC_RELAXED );
+			}
+
+			/// \return start of the wait, pass it to _acquired().
+			Genode::Trace::Timestamp _acquiring()
+			{
+				if ( __atomic_load_n( &_held, __ATOMIC_RELAXED ) )
+				{
+					_count( _contended );
+				}
+
+				return Genode::Trace::timestamp();
+			}
+
+			void _acquired( const Genode::Trace::Timestamp start )
+			{
+				_acquired_at = Genode::Trace::timestamp();
+				__atomic_store_n( &_held, true, __ATOMIC_RELAXED );
+				_count( _acquisitions );
+				_count( _wait[_bucket( _acquired_at - start )] );
+			}
+
+			void _released()
+			{
+				__atomic_store_n( &_held, false, __ATOMIC_RELAXED );
+				_count( _hold[_bucket( Genode::Trace::timestamp() - _acquired_at )] );
+			}
+
+		public:
+			Lock_profile( const char *name ): _name( name ), _next( nullptr ),
+				_acquired_at( 0 ), _held( false )
+			{
+				reset();
+				Genode::Lock::Guard guard( _registry_lock() );
+				_next = _registry();
+				_registry() = this;
+			}
+
+			~Lock_profile()
+			{
+				Genode::Lock::Guard guard( _registry_lock() );
+
+				for ( Lock_profile **p = &_registry(); *p; p = &( *p )->_next )
+				{
+					if ( *p == this )
+					{
+						*p = _next;
+						break;
+					}
+				}
+			}
+
+			const char *name() const
+			{
+				return _name;
+			}
+
+			/// Set the name. The string must stay valid as long as the
+			/// lock exists.
+			void name( const char *name )
+			{
+				_name = name;
+			}
+
+			unsigned long acquisitions() const
+			{
+				return _read( _acquisitions );
+			}
+
+			/// \return the number of acquisitions that found the lock held.
+			unsigned long contended() const
+			{
+				return _read( _contended );
+			}
+
+			unsigned long wait_histogram( const unsigned bucket ) const
+			{
+				return bucket < BUCKETS ? _read( _wait[bucket] ) : 0;
+			}
+
+			unsigned long hold_histogram( const unsigned bucket ) const
+			{
+				return bucket < BUCKETS ? _read( _hold[bucket] ) : 0;
+			}
+
+			void reset()
+			{
+				__atomic_store_n( &_acquisitions, 0UL, __ATOMIC_RELAXED );
+				__atomic_store_n( &_contended, 0UL, __ATOMIC_RELAXED );
+
+				for ( unsigned i = 0; i < BUCKETS; ++i )
+				{
+					__atomic_store_n( &_wait[i], 0UL, __ATOMIC_RELAXED );
+					__atomic_store_n( &_hold[i], 0UL, __ATOMIC_RELAXED );
+				}
+			}
+
+			/// Call f( const Lock_profile & ) for every profiled lock.
+			/// Locks must not be created or destroyed from within f.
+			template <typename FUNC>
+			static void for_each( FUNC const &f )
+			{
+				Genode::Lock::Guard guard( _registry_lock() );
+
+				for ( Lock_profile *p = _registry(); p; p = p->_next )
+				{
+					f( const_cast<const Lock_profile &>( *p ) );
+				}
+			}
+	};
+
+#ifdef CSL_LOCK_PROFILE
+	///
+	/// Genode::Lock which records a Lock_profile.
+	///
+	class Profiled_lock
+	{
+		private:
+			Genode::Lock _lock;
+			Lock_profile _profile;
+
+			Profiled_lock( const Profiled_lock & );
+			Profiled_lock &operator=( const Profiled_lock & );
+
+		public:
+			typedef Genode::Lock_guard<Profiled_lock> Guard;
+
+			explicit Profiled_lock( const char *name = "anonymous" ): _profile( name ) {}
+
+			void lock()
+			{
+				const Genode::Trace::Timestamp start = _profile._acquiring();
+				_lock.lock();
+				_profile._acquired( start );
+			}
+
+			void unlock()
+			{
+				_profile._released();
+				_lock.unlock();
+			}
+
+			void name( const char *name )
+			{
+				_profile.name( name );
+			}
+
+			const Lock_profile *profile() const
+			{
+				return &_profile;
+			}
+	};
+#else
+	class Profiled_lock
+	{
+		private:
+			Genode::Lock _lock;
+
+			Profiled_lock( const Profiled_lock & );
+			Profiled_lock &operator=( const Profiled_lock & );
+
+		public:
+			typedef Genode::Lock_guard<Profiled_lock> Guard;
+
+			explicit Profiled_lock( const char * = nullptr ) {}
+
+			void lock()
+			{
+				_lock.lock();
+			}
+
+			void unlock()
+			{
+				_lock.unlock();
+			}
+
+			void name( const char * ) {}
+
+			/// \return nullptr, profiling is disabled.
+			const Lock_profile *profile() const
+			{
+				return nullptr;
+			}
+	};
+#endif
+
+	///
+	/// Reports the profile of all locks as "lock_profile" every
+	/// period_ms milliseconds. The counts are cumulative. Without
+	/// CSL_LOCK_PROFILE the report is empty.
+	///
+	class Lock_profile_reporter
+	{
+		private:
+			struct Impl;
+			Impl *_impl;
+
+			Lock_profile_reporter( const Lock_profile_reporter & );
+			Lock_profile_reporter &operator=( const Lock_profile_reporter & );
+
+		public:
+			Lock_profile_reporter( Genode::Env &env, unsigned long period_ms );
+			~Lock_profile_reporter();
+
+			/// Generate a report now.
+			void report();
+	};
+} // namespace Csl
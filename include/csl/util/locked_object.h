@@ -15,6 +15,13 @@
 
 #include <base/lock.h>
 #include <base/lock_guard.h>
+#include <util/string.h>
+
+#include <csl/util/rw_lock.h>
+#include <csl/util/lock_profile.h>
+#include <csl/util/type_traits.h>
+#include <csl/util/hash.h>
+#include <csl/util/cache.h>
 
 /// Convenience template for variables that are shared between threads
 /// and should be locked when used. Note that this doesn't guarantee
@@ -39,7 +46,7 @@ namespace Csl
 	{
 		private:
 			O _o;
-			Genode::Lock _lock;
+			Profiled_lock _lock;
 
 			// Copying a locked object is funny. This means you either
 			// don't need a lock, or you didn't intend to copy it in the
@@ -60,9 +67,220 @@ namespace Csl
 			template<typename R, typename FUN>
 			R access( FUN handle )
 			{
-				Genode::Lock_guard<Genode::Lock> guard( _lock );
+				Profiled_lock::Guard guard( _lock );
+				return handle( _o );
+			}
+
+			/// Name the lock in the lock profile.
+			void lock_name( const char *name )
+			{
+				_lock.name( name );
+			}
+	};
+
+	///
+	/// Like locked_object, but readers share access. Use this for
+	/// objects that are read often and written rarely; readers on
+	/// different cpus don't contend with each other.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::rw_locked_object<Sp::Sps> _spd;
+	/// _spd.read<bool>( [&]( const Sp::Sps &spd ) { // for every packet
+	///   return spd.match( packet );
+	/// } );
+	/// _spd.access<void>( [&]( Sp::Sps &spd ) {     // on reconfiguration
+	///   spd.update( config );
+	/// } );
+	///
+	/// \endverbatim
+	///
+	template <typename O>
+	struct rw_locked_object
+	{
+		private:
+			O _o;
+			mutable Rw_lock _lock;
+
+			// See locked_object
+			rw_locked_object( const rw_locked_object &o );
+			rw_locked_object operator=( const rw_locked_object &o );
+		public:
+			typedef O type;
+
+			rw_locked_object( const O &o ): _o( o ) {}
+
+			rw_locked_object(): _o() {}
+
+			/// Exclusive access.
+			template<typename R, typename FUN>
+			R access( FUN handle )
+			{
+				Rw_lock::Write_guard guard( _lock );
 				return handle( _o );
 			}
+
+			/// Shared access, handle receives a const reference.
+			template<typename R, typename FUN>
+			R read( FUN handle ) const
+			{
+				Rw_lock::Read_guard guard( _lock );
+				return handle( const_cast<const O &>( _o ) );
+			}
+	};
+
+	///
+	/// Object protected by a Seqlock, for small trivially copyable
+	/// objects. Readers never block writers and never write shared
+	/// memory: they receive a consistent copy of the object, and retry
+	/// when a write happened while they copied.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::seqlock_object<Counters> _stats;
+	/// Counters now = _stats.read();
+	/// _stats.write( [&]( Counters &c ) { c.bytes += len; } );
+	///
+	/// \endverbatim
+	///
+	template <typename O>
+	struct seqlock_object
+	{
+		private:
+			static_assert( Is_trivially_copyable<O>::VALUE,
+			               "seqlock_object requires a trivially copyable type" );
+
+			O _o;
+			mutable Seqlock _lock;
+
+			// See locked_object
+			seqlock_object( const seqlock_object &o );
+			seqlock_object operator=( const seqlock_object &o );
+		public:
+			typedef O type;
+
+			seqlock_object( const O &o ): _o( o ) {}
+
+			seqlock_object(): _o() {}
+
+			/// \return a consistent copy of the object.
+			O read() const
+			{
+				O copy;
+				unsigned long seq;
+
+				do
+				{
+					seq = _lock.read_begin();
+					Genode::memcpy( &copy, &_o, sizeof( O ) );
+				}
+				while ( _lock.read_retry( seq ) );
+
+				return copy;
+			}
+
+			/// Call handle on a consistent copy of the object.
+			template<typename R, typename FUN>
+			R read( FUN handle ) const
+			{
+				const O copy = read();
+				return handle( copy );
+			}
+
+			/// Modify the object, writers are serialized.
+			template<typename R, typename FUN>
+			R write( FUN handle )
+			{
+				struct Guard
+				{
+					Seqlock &lock;
+					Guard( Seqlock &lock ): lock( lock ) { lock.write_lock(); }
+					~Guard() { lock.write_unlock(); }
+				} guard( _lock );
+
+				return handle( _o );
+			}
+
+			void write( const O &o )
+			{
+				write<void>( [&]( O &dst ) { dst = o; } );
+			}
+	};
+
+	///
+	/// State partitioned over N independently locked shards. A key
+	/// selects its shard with Csl::hash, so threads working on keys in
+	/// different shards don't contend. Each shard holds its own O, e.g.
+	/// the part of a table with the keys of that shard.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::sharded_object<Connection_table, 16> _connections;
+	/// _connections.access<void>( tuple, [&]( Connection_table &t ) {
+	///   t.insert( tuple, connection );
+	/// } );
+	///
+	/// \endverbatim
+	///
+	template <typename O, size_t N = 16>
+	struct sharded_object
+	{
+		private:
+			// keep the shards on separate cache lines
+			Cache_aligned<locked_object<O>> _shards[N];
+
+			// See locked_object
+			sharded_object( const sharded_object &o );
+			sharded_object operator=( const sharded_object &o );
+		public:
+			typedef O type;
+			static const size_t SHARDS = N;
+
+			sharded_object() {}
+
+			/// \return the shard of key.
+			template <typename K>
+			static size_t shard( const K &key )
+			{
+				return hash<K>()( key ) % N;
+			}
+
+			/// Access the shard of key exclusively.
+			template<typename R, typename K, typename FUN>
+			R access( const K &key, FUN handle )
+			{
+				return _shards[shard( key )]->template access<R>( handle );
+			}
+
+			/// Access shard i exclusively.
+			template<typename R, typename FUN>
+			R access_shard( const size_t i, FUN handle )
+			{
+				return _shards[i % N]->template access<R>( handle );
+			}
+
+			/// Call handle( O & ) for every shard, locking one shard at a
+			/// time.
+			template<typename FUN>
+			void for_each( FUN handle )
+			{
+				for ( size_t i = 0; i < N; ++i )
+				{
+					_shards[i]->template access<void>( handle );
+				}
+			}
+
+			/// Name the locks in the lock profile.
+			void lock_name( const char *name )
+			{
+				for ( size_t i = 0; i < N; ++i )
+				{
+					_shards[i]->lock_name( name );
+				}
+			}
 	};
 } //  namespace Csl
 
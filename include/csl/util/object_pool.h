@@ -0,0 +1,198 @@
+///
+/// \file       object_pool.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Pools of fixed-size objects
+///
+
+#pragma once
+
+#include <base/allocator.h>
+#include <util/construct_at.h>
+
+#include <csl/util/stdint.h>
+#include <csl/util/alloc.h>
+
+namespace Csl
+{
+	///
+	/// Pool of objects of type T, for objects that are created and
+	/// destroyed at a high rate.
+	///
+	/// The objects are blocks of the size class of T in the
+	/// Slab_allocator, so they come from its per thread caches, and
+	/// freed objects can be reused by any allocation of that class.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Object_pool<Sa_request> _requests;
+	/// _requests.prewarm( 256 );
+	///
+	/// Csl::Object_pool<Sa_request>::Handle r = _requests.make( spi, dd );
+	/// r->process();
+	/// // released when r goes out of scope
+	///
+	/// \endverbatim
+	///
+	template <typename T>
+	class Object_pool
+	{
+		static_assert( alignof( T ) <= Slab_allocator::ALIGN, "Object_pool aligns at 16 bytes at most" );
+
+		private:
+			Object_pool( const Object_pool & );
+			Object_pool &operator=( const Object_pool & );
+
+		public:
+			///
+			/// Owns an object of the pool, and returns it to the pool on
+			/// destruction. Handles can be moved but not copied.
+			///
+			class Handle
+			{
+				private:
+					Object_pool *_pool;
+					T *_obj;
+
+					Handle( const Handle & );
+					Handle &operator=( const Handle & );
+
+				public:
+					Handle( Object_pool &pool, T *obj ): _pool( &pool ), _obj( obj ) {}
+
+					Handle( Handle &&other ): _pool( other._pool ), _obj( other._obj )
+					{
+						other._obj = nullptr;
+					}
+
+					~Handle()
+					{
+						if ( nullptr != _obj )
+						{
+							_pool->destroy( _obj );
+						}
+					}
+
+					T *get() const
+					{
+						return _obj;
+					}
+
+					T &operator*() const
+					{
+						return *_obj;
+					}
+
+					T *operator->() const
+					{
+						return _obj;
+					}
+			};
+
+			Object_pool() {}
+
+			/// \return a new T, constructed with args.
+			template <typename ...ARGS>
+			T *construct( const ARGS &...args )
+			{
+				void *slot = Slab_allocator::instance().alloc( sizeof( T ) );
+
+				if ( nullptr == slot )
+				{
+					throw Genode::Allocator::Out_of_memory();
+				}
+
+				try
+				{
+					return Genode::construct_at<T>( slot, args... );
+				}
+				catch ( ... )
+				{
+					Slab_allocator::instance().free( slot, sizeof( T ) );
+					throw;
+				}
+			}
+
+			/// Destroy an object made by construct().
+			void destroy( T *obj )
+			{
+				obj->~T();
+				Slab_allocator::instance().free( obj, sizeof( T ) );
+			}
+
+			/// \return a handle to a new T, constructed with args.
+			template <typename ...ARGS>
+			Handle make( const ARGS &...args )
+			{
+				return Handle( *this, construct( args... ) );
+			}
+
+			/// Make sure n objects can be constructed without carving
+			/// new slab chunks.
+			void prewarm( const size_t n )
+			{
+				Slab_allocator::instance().reserve( sizeof( T ), n );
+			}
+	};
+
+	///
+	/// Mixin that allocates every new T, and every object derived from
+	/// it, from the Slab_allocator size classes, and frees it with its
+	/// size so the free doesn't read the block header.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// struct Esp_payload: Payload, Csl::Pool_allocated<Esp_payload> { ... };
+	///
+	/// \endverbatim
+	///
+	template <typename T>
+	struct Pool_allocated
+	{
+		static void *operator new( size_t size )
+		{
+			void *p = Slab_allocator::instance().alloc( size );
+
+			if ( nullptr == p )
+			{
+				throw Genode::Allocator::Out_of_memory();
+			}
+
+			return p;
+		}
+
+		static void operator delete( void *p, size_t size )
+		{
+			Slab_allocator::instance().free( p, size );
+		}
+
+		/// Placement forms, for allocation from a Genode::Allocator
+		static void *operator new( size_t size, Genode::Allocator *alloc )
+		{
+			return ::operator new( size, alloc );
+		}
+
+		static void *operator new( size_t size, Genode::Allocator &alloc )
+		{
+			return ::operator new( size, alloc );
+		}
+
+		static void operator delete( void *p, Genode::Allocator *alloc )
+		{
+			::operator delete( p, alloc );
+		}
+
+		static void operator delete( void *p, Genode::Allocator &alloc )
+		{
+			::operator delete( p, alloc );
+		}
+	};
+} // namespace Csl
@@ -0,0 +1,338 @@
+///
+/// \file       parallel.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Parallel algorithms on top of the Thread_pool
+///
+
+#pragma once
+
+#include <base/semaphore.h>
+
+#include <csl/util/thread_pool.h>
+#include <csl/util/data_descriptor.h>
+#include <csl/util/algorithm.h>
+#include <csl/util/exception.h>
+
+///
+/// The algorithms split a range in chunks of grain elements, and run
+/// the chunks as tasks on a Thread_pool. The calling thread executes
+/// pool tasks itself while it waits for the chunks to finish. When f
+/// throws for a chunk, the other chunks still run and the algorithm
+/// throws Parallel_failure once all chunks finished.
+///
+/// Example:
+/// \verbatim
+///
+/// // hex encode a dump, two output octets per input octet
+/// Csl::parallel_transform( pool, dump, out, []( Csl::Data_descriptor in,
+///                                               Csl::Data_descriptor_mod out ) {
+///   encode( in, out );
+/// } );
+///
+/// \endverbatim
+///
+
+namespace Csl
+{
+	///
+	/// Default number of octets per chunk when splitting a
+	/// Data_descriptor: small enough to stay in the L1/L2 cache,
+	/// large enough to amortize the cost of a task.
+	///
+	static const size_t DEFAULT_GRAIN = 16 * 1024;
+
+	///
+	/// Chunks of octets are rounded up to a multiple of this, so that
+	/// two chunks written by different threads never share a cache line.
+	///
+	static const size_t CHUNK_ALIGN = 64;
+
+	///
+	/// Thrown by the algorithms when f threw for a chunk, with the
+	/// message of the first failing chunk. The other chunks still run.
+	///
+	EXCEPTION( Parallel_failure );
+
+	namespace Parallel
+	{
+		///
+		/// Runs the chunks [0, chunks) of a range as tasks, and waits
+		/// for them to complete.
+		///
+		template <typename FUNC>
+		class Chunked_job
+		{
+			private:
+				struct Chunk: Task
+				{
+					Chunked_job *job;
+					size_t index;
+
+					void execute() override
+					{
+						job->_run_chunk( index );
+						job->_done();
+					}
+				};
+
+				FUNC const &_func;
+				Atomic_variable<size_t> _remaining;
+				Genode::Semaphore _finished;
+				Atomic_variable<bool> _failed;
+				Parallel_failure _failure;      // of the first failing chunk
+
+				void _fail( const char *what )
+				{
+					if ( not _failed.exchange( true ) )
+					{
+						_failure = Parallel_failure( what );
+					}
+				}
+
+				void _run_chunk( const size_t index )
+				{
+					try
+					{
+						_func( index );
+					}
+					catch ( Exception &e )
+					{
+						_fail( e.what() );
+					}
+					catch ( ... )
+					{
+						_fail( "unknown exception" );
+					}
+				}
+
+				void _done()
+				{
+					if ( 1 == _remaining.fetch_sub( 1 ) )
+					{
+						_finished.up();
+					}
+				}
+
+			public:
+				Chunked_job( FUNC const &func ): _func( func ), _remaining( size_t( 0 ) ),
+					_finished( 0 ), _failed( false ) {}
+
+				/// Run the chunks, and wait until all of them finished,
+				/// also when some of them fail.
+				///
+				/// \throw Parallel_failure when a chunk threw.
+				///
+				void run( Thread_pool &pool, const size_t chunks )
+				{
+					if ( 0 == chunks )
+					{
+						return;
+					}
+
+					if ( 1 == chunks )
+					{
+						_run_chunk( 0 );
+					}
+					else
+					{
+						Chunk *tasks = new Chunk[chunks];
+						_remaining = chunks;
+
+						for ( size_t i = 0; i < chunks; ++i )
+						{
+							tasks[i].job = this;
+							tasks[i].index = i;
+							pool.submit( tasks[i] );
+						}
+
+						try
+						{
+							while ( 0 != _remaining.load() && pool.help() ) {}
+						}
+						catch ( ... )
+						{
+							// another task of the pool threw, the chunks
+							// still refer to this job
+							_finished.down();
+							delete[] tasks;
+							throw;
+						}
+
+						_finished.down();
+						delete[] tasks;
+					}
+
+					if ( _failed.load() )
+					{
+						throw _failure;
+					}
+				}
+		};
+
+		inline size_t chunks( const size_t size, const size_t grain )
+		{
+			return ( size + grain - 1 ) / grain;
+		}
+
+		inline size_t aligned_grain( const size_t grain )
+		{
+			const size_t g = grain ? grain : DEFAULT_GRAIN;
+			return ( g + CHUNK_ALIGN - 1 ) & ~( CHUNK_ALIGN - 1 );
+		}
+	}
+
+	/// Call f( chunk_begin, chunk_end ) for every chunk of [begin, end).
+	///
+	/// \param pool   pool to run the chunks on.
+	/// \param begin  first index.
+	/// \param end    one past the last index.
+	/// \param grain  maximum number of indices per chunk.
+	/// \param f      function called as f( size_t begin, size_t end ).
+	///
+	template <typename FUNC>
+	void parallel_for( Thread_pool &pool, const size_t begin, const size_t end,
+	                   const size_t grain, FUNC const &f )
+	{
+		cslassert( begin <= end );
+		const size_t g = grain ? grain : 1;
+
+		auto chunk = [&]( size_t i )
+		{
+			const size_t b = begin + i * g;
+			f( b, min( b + g, end ) );
+		};
+
+		Parallel::Chunked_job<decltype( chunk )>( chunk ).run(
+		    pool, Parallel::chunks( end - begin, g ) );
+	}
+
+	/// Call f( chunk ) for every chunk of dd.
+	///
+	/// \param pool   pool to run the chunks on.
+	/// \param dd     the data to split.
+	/// \param f      function called as f( Data_descriptor_template<T> chunk ).
+	/// \param grain  octets per chunk, rounded up to CHUNK_ALIGN.
+	///
+	template <typename T, typename FUNC>
+	void parallel_for( Thread_pool &pool, const Data_descriptor_template<T> &dd,
+	                   FUNC const &f, const size_t grain = DEFAULT_GRAIN )
+	{
+		parallel_for( pool, 0, dd.size(), Parallel::aligned_grain( grain ),
+		              [&]( size_t b, size_t e )
+		{
+			f( Data_descriptor_template<T>( dd.data() + b, e - b ) );
+		} );
+	}
+
+	/// Reduce the chunks of [begin, end) to a single value.
+	///
+	/// Chunk results are combined in index order, so combine needs to
+	/// be associative but not commutative. R must be default
+	/// constructible.
+	///
+	/// \param identity  initial value, and the value of an empty range.
+	/// \param map       called as R map( size_t begin, size_t end ) per chunk.
+	/// \param combine   called as R combine( const R &left, const R &right ).
+	///
+	/// \return the combined value of all chunks.
+	///
+	template <typename R, typename MAP, typename COMBINE>
+	R parallel_reduce( Thread_pool &pool, const size_t begin, const size_t end,
+	                   const size_t grain, const R &identity,
+	                   MAP const &map, COMBINE const &combine )
+	{
+		cslassert( begin <= end );
+		const size_t g = grain ? grain : 1;
+		const size_t n = Parallel::chunks( end - begin, g );
+
+		if ( 0 == n )
+		{
+			return identity;
+		}
+
+		R *results = new R[n];
+
+		auto chunk = [&]( size_t i )
+		{
+			const size_t b = begin + i * g;
+			results[i] = map( b, min( b + g, end ) );
+		};
+
+		try
+		{
+			Parallel::Chunked_job<decltype( chunk )>( chunk ).run( pool, n );
+		}
+		catch ( ... )
+		{
+			delete[] results;
+			throw;
+		}
+
+		R result = identity;
+
+		for ( size_t i = 0; i < n; ++i )
+		{
+			result = combine( result, results[i] );
+		}
+
+		delete[] results;
+		return result;
+	}
+
+	/// Reduce the chunks of dd to a single value.
+	///
+	/// \param map  called as R map( Data_descriptor_template<T> chunk ).
+	///
+	/// \see parallel_reduce
+	///
+	template <typename R, typename T, typename MAP, typename COMBINE>
+	R parallel_reduce( Thread_pool &pool, const Data_descriptor_template<T> &dd,
+	                   const R &identity, MAP const &map, COMBINE const &combine,
+	                   const size_t grain = DEFAULT_GRAIN )
+	{
+		return parallel_reduce( pool, 0, dd.size(), Parallel::aligned_grain( grain ),
+		                        identity, [&]( size_t b, size_t e )
+		{
+			return map( Data_descriptor_template<T>( dd.data() + b, e - b ) );
+		}, combine );
+	}
+
+	/// Transform src into dst chunk by chunk.
+	///
+	/// dst.size() must be a multiple of src.size(); every chunk of src
+	/// is paired with the proportional chunk of dst. E.g. hex encoding
+	/// uses a dst twice as big as src.
+	///
+	/// \param src    the input.
+	/// \param dst    the output.
+	/// \param f      called as f( Data_descriptor in, Data_descriptor_mod out ).
+	/// \param grain  octets of src per chunk, rounded up to CHUNK_ALIGN.
+	///
+	template <typename T, typename FUNC>
+	void parallel_transform( Thread_pool &pool, const Data_descriptor_template<T> &src,
+	                         const Data_descriptor_mod &dst, FUNC const &f,
+	                         const size_t grain = DEFAULT_GRAIN )
+	{
+		if ( 0 == src.size() )
+		{
+			return;
+		}
+
+		cslassert( 0 == dst.size() % src.size() );
+		const size_t ratio = dst.size() / src.size();
+
+		parallel_for( pool, 0, src.size(), Parallel::aligned_grain( grain ),
+		              [&]( size_t b, size_t e )
+		{
+			f( Data_descriptor_template<T>( src.data() + b, e - b ),
+			   Data_descriptor_mod( dst.data() + b * ratio, ( e - b ) * ratio ) );
+		} );
+	}
+} // namespace Csl
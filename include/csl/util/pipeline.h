@@ -0,0 +1,715 @@
+///
+/// \file       pipeline.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Multi-stage pipeline with batched handoff between threads
+///
+
+#pragma once
+
+#include <base/env.h>
+#include <base/lock.h>
+#include <base/affinity.h>
+
+#include <csl/util/thread.h>
+#include <csl/util/thread_pool.h>
+#include <csl/util/sync.h>
+#include <csl/util/atomic.h>
+#include <csl/util/string.h>
+#include <csl/util/exception.h>
+#include <csl/util/logger.h>
+
+///
+/// A Pipeline passes items through a chain of stages. Every stage
+/// runs on its own thread, or on a Thread_pool, and stages hand items
+/// to the next stage in batches, so the cost of a handoff is shared by
+/// all items in the batch.
+///
+/// Stages are connected by bounded queues of DEPTH batches. When a
+/// stage falls behind, its queue fills up and the stage in front of it
+/// waits: backpressure propagates up to push(). Pool stages don't block
+/// their workers while they wait, they retry the handoff later.
+///
+/// A stage whose process() throws loses the batch. The failure is
+/// logged and counted in the Metrics of the stage.
+///
+/// Example:
+/// \verbatim
+///
+/// typedef Csl::Pipeline<Packet *> Packet_pipeline;
+///
+/// struct Decrypt: Packet_pipeline::Stage {
+///   void process( Packet_pipeline::Batch &b ) override {
+///     b.retain( [&]( Packet *p ) { return sa.decrypt( *p ); } );
+///   }
+/// };
+///
+/// Packet_pipeline pipeline( env, "rx" );
+/// pipeline.add( classify, Genode::Affinity::Location( 1, 0 ) );
+/// pipeline.add( decrypt, pool );  // stateless, spread over the pool
+/// pipeline.add( forward, Genode::Affinity::Location( 2, 0 ) );
+/// pipeline.start();
+///
+/// while ( nic.rx( p ) ) pipeline.push( p );
+/// pipeline.flush();               // don't hold back a partial batch
+/// ...
+/// pipeline.close();               // drain and stop
+///
+/// \endverbatim
+///
+
+namespace Csl
+{
+	///
+	/// Fixed capacity array of items, the unit of handoff between
+	/// pipeline stages.
+	///
+	template <typename T, size_t CAPACITY>
+	class Batch
+	{
+		private:
+			T _items[CAPACITY];
+			size_t _count;
+
+		public:
+			Batch(): _count( 0 ) {}
+
+			/// \return false iff the batch is full.
+			bool add( const T &item )
+			{
+				if ( full() )
+				{
+					return false;
+				}
+
+				_items[_count++] = item;
+				return true;
+			}
+
+			T &operator[]( const size_t i )
+			{
+				cslassert( i < _count );
+				return _items[i];
+			}
+
+			const T &operator[]( const size_t i ) const
+			{
+				cslassert( i < _count );
+				return _items[i];
+			}
+
+			/// Keep the items for which keep( T & ) returns true, in order.
+			template <typename FUNC>
+			void retain( FUNC const &keep )
+			{
+				size_t kept = 0;
+
+				for ( size_t i = 0; i < _count; ++i )
+				{
+					if ( keep( _items[i] ) )
+					{
+						_items[kept++] = _items[i];
+					}
+				}
+
+				_count = kept;
+			}
+
+			template <typename FUNC>
+			void for_each( FUNC const &f )
+			{
+				for ( size_t i = 0; i < _count; ++i )
+				{
+					f( _items[i] );
+				}
+			}
+
+			void clear()
+			{
+				_count = 0;
+			}
+
+			size_t size() const
+			{
+				return _count;
+			}
+
+			bool empty() const
+			{
+				return 0 == _count;
+			}
+
+			bool full() const
+			{
+				return CAPACITY == _count;
+			}
+
+			static constexpr size_t capacity()
+			{
+				return CAPACITY;
+			}
+	};
+
+	///
+	/// Bounded queue that can be closed. After close(), put() fails,
+	/// and get() returns the remaining values before it fails too.
+	///
+	template <typename T, size_t DEPTH>
+	class Batch_queue
+	{
+		private:
+			Genode::Lock _lock;
+			Condition _not_empty;
+			Condition _not_full;
+			T _ring[DEPTH];
+			size_t _head;
+			size_t _count;
+			bool _closed;
+
+			// metrics
+			Atomic_variable<unsigned long> _blocked;
+			Atomic_variable<size_t> _max_depth;
+
+			Batch_queue( const Batch_queue & );
+			Batch_queue &operator=( const Batch_queue & );
+
+			/// Append val, the caller holds _lock and checked for space.
+			void _append( const T &val )
+			{
+				_ring[( _head + _count ) % DEPTH] = val;
+				++_count;
+
+				if ( _count > _max_depth.load( Memory_order::relaxed ) )
+				{
+					_max_depth.store( _count, Memory_order::relaxed );
+				}
+
+				_not_empty.notify_one();
+			}
+
+		public:
+			Batch_queue(): _head( 0 ), _count( 0 ), _closed( false ),
+				_blocked( 0UL ), _max_depth( size_t( 0 ) ) {}
+
+			/// Put a value, blocks while the queue is full.
+			///
+			/// \return false iff the queue was closed.
+			///
+			bool put( const T &val )
+			{
+				Genode::Lock::Guard guard( _lock );
+
+				if ( DEPTH == _count && not _closed )
+				{
+					_blocked.fetch_add( 1, Memory_order::relaxed );
+					_not_full.wait( _lock, [&]() { return _count < DEPTH || _closed; } );
+				}
+
+				if ( _closed )
+				{
+					return false;
+				}
+
+				_append( val );
+				return true;
+			}
+
+			/// Put a value unless the queue is full or closed, never blocks.
+			///
+			/// \return false iff the value wasn't put.
+			///
+			bool try_put( const T &val )
+			{
+				Genode::Lock::Guard guard( _lock );
+
+				if ( DEPTH == _count || _closed )
+				{
+					return false;
+				}
+
+				_append( val );
+				return true;
+			}
+
+			/// Get a value, blocks while the queue is empty and open.
+			///
+			/// \return false iff the queue is closed and empty.
+			///
+			bool get( T &val )
+			{
+				Genode::Lock::Guard guard( _lock );
+				_not_empty.wait( _lock, [&]() { return _count > 0 || _closed; } );
+
+				if ( 0 == _count )
+				{
+					return false;
+				}
+
+				val = _ring[_head];
+				_head = ( _head + 1 ) % DEPTH;
+				--_count;
+				_not_full.notify_one();
+				return true;
+			}
+
+			void close()
+			{
+				Genode::Lock::Guard guard( _lock );
+				_closed = true;
+				_not_empty.notify_all();
+				_not_full.notify_all();
+			}
+
+			bool closed()
+			{
+				Genode::Lock::Guard guard( _lock );
+				return _closed;
+			}
+
+			/// \return the number of values in the queue.
+			size_t depth()
+			{
+				Genode::Lock::Guard guard( _lock );
+				return _count;
+			}
+
+			/// \return the highest depth seen.
+			size_t max_depth() const
+			{
+				return _max_depth.load( Memory_order::relaxed );
+			}
+
+			/// \return how often put() had to wait for space.
+			unsigned long blocked() const
+			{
+				return _blocked.load( Memory_order::relaxed );
+			}
+	};
+
+	///
+	/// Chain of stages processing items of type T.
+	///
+	/// push() and flush() must be called from a single thread. Batches
+	/// are allocated by push() and freed after the last stage.
+	///
+	/// \param T           item type, default constructible and copyable.
+	/// \param BATCH_SIZE  items per batch.
+	/// \param DEPTH       batches queued in front of every stage.
+	///
+	template <typename T, size_t BATCH_SIZE = 32, size_t DEPTH = 8>
+	class Pipeline
+	{
+		public:
+			static const unsigned MAX_STAGES = 8;
+
+			typedef Csl::Batch<T, BATCH_SIZE> Batch;
+
+			///
+			/// A stage of the pipeline. process() may modify, drop or
+			/// reorder the items of the batch; the remaining items go to
+			/// the next stage. Stages that run on a pool may process
+			/// several batches at once, and batches may overtake each
+			/// other there.
+			///
+			class Stage
+			{
+				public:
+					virtual void process( Batch &batch ) = 0;
+					virtual ~Stage() {}
+			};
+
+			///
+			/// Counters of a stage.
+			///
+			struct Metrics
+			{
+				unsigned long batches;   ///< batches processed
+				unsigned long items;     ///< items received
+				unsigned long blocked;   ///< times the upstream waited for space
+				unsigned long failed;    ///< batches lost because process() threw
+				size_t depth;            ///< batches queued (thread stages)
+				size_t max_depth;        ///< highest depth seen (thread stages)
+			};
+
+		private:
+			class Stage_thread;
+
+			struct Stage_slot
+			{
+				Stage *stage;
+				Thread_pool *pool;
+				Stage_thread *thread;
+				Batch_queue<Batch *, DEPTH> input;
+				Semaphore in_flight;       // free places, pool stages
+				Atomic_variable<unsigned long> batches;
+				Atomic_variable<unsigned long> items;
+				Atomic_variable<unsigned long> blocked;
+				Atomic_variable<unsigned long> failed;
+
+				Stage_slot(): stage( nullptr ), pool( nullptr ), thread( nullptr ),
+					in_flight( DEPTH ), batches( 0UL ), items( 0UL ), blocked( 0UL ),
+					failed( 0UL ) {}
+			};
+
+			class Stage_thread: public Genode::Thread
+			{
+				private:
+					Pipeline &_pipeline;
+					const unsigned _index;
+				public:
+					Stage_thread( Genode::Env &env, Pipeline &pipeline, unsigned index,
+					              const char *name, Genode::Affinity::Location location ):
+						Genode::Thread( env, name, DEFAULT_STACK_SIZE, location, Weight(),
+						                env.cpu() ),
+						_pipeline( pipeline ), _index( index )
+					{}
+
+					void entry() override
+					{
+						_pipeline._run( _index );
+					}
+			};
+
+			Genode::Env &_env;
+			const string _name;
+			Stage_slot _stages[MAX_STAGES];
+			unsigned _count;
+			Batch *_input;
+			bool _started;
+			bool _closed;
+
+			Pipeline( const Pipeline & );
+			Pipeline &operator=( const Pipeline & );
+
+			void _process( const unsigned i, Batch *batch )
+			{
+				Stage_slot &s = _stages[i];
+				s.items.fetch_add( batch->size(), Memory_order::relaxed );
+
+				try
+				{
+					s.stage->process( *batch );
+				}
+				catch ( Exception &e )
+				{
+					_failed( i, batch, e.what() );
+				}
+				catch ( ... )
+				{
+					_failed( i, batch, "unknown exception" );
+				}
+
+				s.batches.fetch_add( 1, Memory_order::relaxed );
+			}
+
+			/// Drop the batch, the stage may have left it half processed.
+			void _failed( const unsigned i, Batch *batch, const char *what )
+			{
+				_stages[i].failed.fetch_add( 1, Memory_order::relaxed );
+				ELOG( "%s: stage %u lost a batch of %lu items: %s", _name.c_str(), i,
+				      batch->size(), what );
+				batch->clear();
+			}
+
+			void _submit( const unsigned i, Batch *batch )
+			{
+				_stages[i].pool->submit( [this, i, batch]()
+				{
+					_process( i, batch );
+					_forward( i, batch, true );
+				} );
+			}
+
+			/// Hand batch to stage i unless stage i is full.
+			///
+			/// \return false iff stage i is full.
+			///
+			bool _try_deliver( const unsigned i, Batch *batch )
+			{
+				if ( i == _count || batch->empty() )
+				{
+					delete batch;
+					return true;
+				}
+
+				Stage_slot &s = _stages[i];
+
+				if ( nullptr != s.thread )
+				{
+					if ( s.input.try_put( batch ) )
+					{
+						return true;
+					}
+
+					if ( s.input.closed() )
+					{
+						delete batch;
+						return true;
+					}
+
+					return false;
+				}
+
+				if ( not s.in_flight.try_down() )
+				{
+					return false;
+				}
+
+				_submit( i, batch );
+				return true;
+			}
+
+			/// Hand batch from pool stage i to the next stage. Workers
+			/// never block: while the next stage is full, the handoff is
+			/// retried by a task deferred behind the other tasks of the
+			/// pool, and stage i keeps the place of the batch meanwhile.
+			void _forward( const unsigned i, Batch *batch, const bool first )
+			{
+				if ( not _try_deliver( i + 1, batch ) )
+				{
+					if ( first )
+					{
+						_stages[i + 1].blocked.fetch_add( 1, Memory_order::relaxed );
+					}
+
+					_stages[i].pool->defer( [this, i, batch]() { _forward( i, batch, false ); } );
+					return;
+				}
+
+				_stages[i].in_flight.up();
+			}
+
+			/// Hand batch to stage i, blocks while stage i is full.
+			void _deliver( const unsigned i, Batch *batch )
+			{
+				if ( i == _count || batch->empty() )
+				{
+					delete batch;
+					return;
+				}
+
+				Stage_slot &s = _stages[i];
+
+				if ( nullptr != s.thread )
+				{
+					if ( not s.input.put( batch ) )
+					{
+						delete batch;
+					}
+
+					return;
+				}
+
+				if ( not s.in_flight.try_down() )
+				{
+					s.blocked.fetch_add( 1, Memory_order::relaxed );
+					s.in_flight.down();
+				}
+
+				_submit( i, batch );
+			}
+
+			/// Wait until stage i has handled all its batches, then close
+			/// the stages after it.
+			void _close( const unsigned i )
+			{
+				if ( i == _count )
+				{
+					return;
+				}
+
+				Stage_slot &s = _stages[i];
+
+				if ( nullptr != s.thread )
+				{
+					// the thread closes the next stage once it's drained
+					s.input.close();
+					return;
+				}
+
+				for ( size_t n = 0; n < DEPTH; ++n )
+				{
+					s.in_flight.down();
+				}
+
+				for ( size_t n = 0; n < DEPTH; ++n )
+				{
+					s.in_flight.up();
+				}
+
+				_close( i + 1 );
+			}
+
+			void _run( const unsigned i )
+			{
+				Batch *batch = nullptr;
+
+				while ( _stages[i].input.get( batch ) )
+				{
+					_process( i, batch );
+					_deliver( i + 1, batch );
+				}
+
+				_close( i + 1 );
+			}
+
+			void _add( Stage &stage )
+			{
+				cslassert( not _started );
+				cslassert( _count < MAX_STAGES );
+				_stages[_count].stage = &stage;
+			}
+
+		public:
+			/// Constructor
+			///
+			/// \param env   the environment
+			/// \param name  name prefix of the stage threads
+			///
+			Pipeline( Genode::Env &env, const char *name = "pipeline" ):
+				_env( env ), _name( name ), _count( 0 ), _input( new Batch() ),
+				_started( false ), _closed( false )
+			{}
+
+			/// Drains the pipeline, see close().
+			~Pipeline()
+			{
+				close();
+				delete _input;
+
+				for ( unsigned i = 0; i < _count; ++i )
+				{
+					delete _stages[i].thread;
+				}
+			}
+
+			/// Add a stage that runs on its own thread.
+			///
+			/// \param stage     the stage, must outlive the pipeline.
+			/// \param location  cpu of the thread, an invalid location
+			///                  (the default) leaves the choice to Genode.
+			///
+			void add( Stage &stage,
+			          Genode::Affinity::Location location = Genode::Affinity::Location() )
+			{
+				_add( stage );
+				const string name = sprintf( "%s.%u", _name.c_str(), _count );
+				_stages[_count].thread = new Stage_thread( _env, *this, _count, name.c_str(),
+				                                           location );
+				++_count;
+			}
+
+			/// Add a stage that runs on a pool, up to DEPTH batches at once.
+			/// The tasks of the stage don't block while the next stage is
+			/// full, so consecutive stages may share a pool.
+			void add( Stage &stage, Thread_pool &pool )
+			{
+				_add( stage );
+				_stages[_count].pool = &pool;
+				++_count;
+			}
+
+			/// Start the stage threads. Add all stages first.
+			void start()
+			{
+				cslassert( not _started );
+				_started = true;
+
+				for ( unsigned i = 0; i < _count; ++i )
+				{
+					if ( nullptr != _stages[i].thread )
+					{
+						_stages[i].thread->start();
+					}
+				}
+			}
+
+			/// Add an item to the current batch, and hand the batch to the
+			/// first stage when it is full. Blocks while the first stage
+			/// is full.
+			///
+			/// \return false iff the pipeline was closed.
+			///
+			bool push( const T &item )
+			{
+				if ( _closed )
+				{
+					return false;
+				}
+
+				_input->add( item );
+
+				if ( _input->full() )
+				{
+					flush();
+				}
+
+				return true;
+			}
+
+			/// Hand the current batch to the first stage, even if it isn't
+			/// full. Call this when the input runs dry, so that items
+			/// aren't held back.
+			void flush()
+			{
+				cslassert( _started );
+
+				if ( _input->empty() )
+				{
+					return;
+				}
+
+				_deliver( 0, _input );
+				_input = new Batch();
+			}
+
+			/// Flush, let every stage finish the batches it has queued,
+			/// and stop the stage threads.
+			void close()
+			{
+				if ( _closed || not _started )
+				{
+					_closed = true;
+					return;
+				}
+
+				flush();
+				_closed = true;
+				_close( 0 );
+
+				for ( unsigned i = 0; i < _count; ++i )
+				{
+					if ( nullptr != _stages[i].thread )
+					{
+						_stages[i].thread->join();
+					}
+				}
+			}
+
+			unsigned stages() const
+			{
+				return _count;
+			}
+
+			/// \return the counters of stage i.
+			Metrics metrics( const unsigned i )
+			{
+				cslassert( i < _count );
+				Stage_slot &s = _stages[i];
+				Metrics m;
+				m.batches = s.batches.load( Memory_order::relaxed );
+				m.items = s.items.load( Memory_order::relaxed );
+				m.blocked = s.blocked.load( Memory_order::relaxed ) + s.input.blocked();
+				m.failed = s.failed.load( Memory_order::relaxed );
+				m.depth = nullptr != s.thread ? s.input.depth() : DEPTH - s.in_flight.count();
+				m.max_depth = s.input.max_depth();
+				return m;
+			}
+	};
+} // namespace Csl
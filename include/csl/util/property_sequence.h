@@ -243,7 +243,8 @@ namespace Csl
 			void get( T &t ) const
 			{
 				item *i = _get( P );
-				t = *( ( T * ) i->data );
+				// i->data needn't be aligned for T
+				__builtin_memcpy( &t, i->data, sizeof( T ) );
 			}
 
 			template<Property P>
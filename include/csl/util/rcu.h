@@ -0,0 +1,231 @@
+///
+/// \file       rcu.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Epoch based read-copy-update
+///
+
+#pragma once
+
+#include <base/lock.h>
+#include <base/lock_guard.h>
+
+#include <csl/util/thread.h>
+#include <csl/util/atomic.h>
+#include <csl/util/cache.h>
+
+namespace Csl
+{
+	///
+	/// Tracks the readers of RCU protected data.
+	///
+	/// Readers register in a per thread slot, in the counter of the
+	/// current epoch. synchronize() starts a new epoch and waits until
+	/// the readers of the previous epoch have left, twice, so both
+	/// counters are drained. Readers that enter meanwhile register in
+	/// the new epoch, so they can't keep the writer waiting.
+	///
+	class Rcu_domain
+	{
+		public:
+			static const unsigned READER_SLOTS = 8;
+
+			///
+			/// Identifies a read-side critical section, returned by
+			/// read_lock() and passed to read_unlock().
+			///
+			struct Read_token
+			{
+				unsigned slot;
+				unsigned epoch;
+			};
+
+		private:
+			/// Readers per epoch parity
+			struct Reader_slot
+			{
+				Atomic_variable<long> count[2];
+			};
+
+			Cache_aligned<Reader_slot> _readers[READER_SLOTS];
+			Atomic_variable<unsigned> _epoch;
+			Genode::Lock _sync_lock;
+
+			Rcu_domain( const Rcu_domain & );
+			Rcu_domain &operator=( const Rcu_domain & );
+
+			long _readers_in( const unsigned epoch ) const
+			{
+				long n = 0;
+
+				for ( unsigned i = 0; i < READER_SLOTS; ++i )
+				{
+					n += _readers[i]->count[epoch].load( Memory_order::acquire );
+				}
+
+				return n;
+			}
+
+		public:
+			Rcu_domain(): _epoch( 0U ) {}
+
+			/// Enter a read-side critical section. Critical sections may
+			/// nest, but must not call synchronize().
+			Read_token read_lock()
+			{
+				Read_token token;
+				token.slot = thread_slot( READER_SLOTS );
+				token.epoch = _epoch.load( Memory_order::relaxed ) & 1;
+				_readers[token.slot]->count[token.epoch].fetch_add( 1 );
+
+				// order the registration before reading the protected data
+				atomic_thread_fence( Memory_order::seq_cst );
+				return token;
+			}
+
+			void read_unlock( const Read_token &token )
+			{
+				_readers[token.slot]->count[token.epoch].fetch_sub( 1, Memory_order::release );
+			}
+
+			/// Wait until all read-side critical sections that were
+			/// entered before the call have been left.
+			void synchronize()
+			{
+				Genode::Lock_guard<Genode::Lock> guard( _sync_lock );
+
+				// order the writer's update before checking for readers
+				atomic_thread_fence( Memory_order::seq_cst );
+
+				// A reader may read the epoch, stall, and register under
+				// a parity that a previous synchronize() already drained.
+				// Flipping twice drains both parities, so such a reader is
+				// waited for as well (as in SRCU).
+				for ( unsigned i = 0; i < 2; ++i )
+				{
+					const unsigned old = _epoch.fetch_add( 1 ) & 1;
+
+					while ( 0 != _readers_in( old ) )
+					{
+						cpu_relax();
+					}
+				}
+			}
+
+			class Read_guard
+			{
+				private:
+					Rcu_domain &_domain;
+					const Read_token _token;
+				public:
+					Read_guard( Rcu_domain &domain ): _domain( domain ),
+						_token( domain.read_lock() ) {}
+					~Read_guard()
+					{
+						_domain.read_unlock( _token );
+					}
+			};
+	};
+
+	///
+	/// Read-mostly object, protected by read-copy-update.
+	///
+	/// Readers access the current version of the object without
+	/// taking a lock. Writers update a copy, and publish it with a
+	/// single pointer swap. The previous version is deleted once all
+	/// readers that could still see it have left.
+	///
+	/// Use this for data that is read on every request and changes
+	/// rarely, such as configuration snapshots and policy tables.
+	/// Writers are expensive: every update copies the object and waits
+	/// for the readers.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::rcu_object<Policy_table> _policies;
+	/// _policies.read<bool>( [&]( const Policy_table &p ) { // for every packet
+	///   return p.allows( packet );
+	/// } );
+	/// _policies.update( [&]( Policy_table &p ) {           // on reconfiguration
+	///   p.add( rule );
+	/// } );
+	///
+	/// \endverbatim
+	///
+	template <typename O>
+	class rcu_object
+	{
+		private:
+			mutable Rcu_domain _domain;
+			Atomic_variable<O *> _current;
+			Genode::Lock _update_lock;
+
+			rcu_object( const rcu_object & );
+			rcu_object &operator=( const rcu_object & );
+
+			void _publish( O *next )
+			{
+				O *previous = _current.exchange( next );
+				_domain.synchronize();
+				delete previous;
+			}
+
+		public:
+			typedef O type;
+
+			rcu_object( const O &o ): _current( new O( o ) ) {}
+
+			rcu_object(): _current( new O() ) {}
+
+			~rcu_object()
+			{
+				delete _current.load();
+			}
+
+			/// Call handle on the current version. The reference is only
+			/// valid while handle runs.
+			template<typename R, typename FUN>
+			R read( FUN handle ) const
+			{
+				Rcu_domain::Read_guard guard( _domain );
+				return handle( const_cast<const O &>( *_current.load( Memory_order::acquire ) ) );
+			}
+
+			/// Copy the current version, let handle modify the copy, then
+			/// publish it. When handle throws, the copy is discarded.
+			/// Updates are serialized, concurrent readers aren't blocked.
+			template<typename FUN>
+			void update( FUN handle )
+			{
+				Genode::Lock_guard<Genode::Lock> guard( _update_lock );
+				O *next = new O( *_current.load() );
+
+				try
+				{
+					handle( *next );
+				}
+				catch ( ... )
+				{
+					delete next;
+					throw;
+				}
+
+				_publish( next );
+			}
+
+			/// Replace the object.
+			void publish( const O &o )
+			{
+				O *next = new O( o );
+				Genode::Lock_guard<Genode::Lock> guard( _update_lock );
+				_publish( next );
+			}
+	};
+} // namespace Csl
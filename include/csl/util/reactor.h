@@ -0,0 +1,336 @@
+///
+/// \file       reactor.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Event loop for signals, timeouts and queues on one entrypoint
+///
+
+#pragma once
+
+#include <base/env.h>
+#include <base/entrypoint.h>
+#include <base/signal.h>
+#include <timer_session/connection.h>
+
+#include <csl/util/type_traits.h>
+
+namespace Csl
+{
+	///
+	/// Dispatches Genode signals, timeouts and libcsl queues on a
+	/// single entrypoint, so one thread serves all event sources of a
+	/// component instead of one thread per source.
+	///
+	/// Dispatch is batched: a queue handler handles up to batch queued
+	/// items per dispatch, and all timeouts that expired are handled on
+	/// a single timer signal. Signals that arrive while a handler runs
+	/// are coalesced by Genode.
+	///
+	/// Signal and queue sources stay registered until they are passed
+	/// to remove(), or until the reactor is destroyed. Components that
+	/// register sources per session or connection must remove them.
+	///
+	/// All methods are to be called from the entrypoint, except
+	/// Notifier::notify(), which can be called from any thread.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Reactor reactor( env );
+	///
+	/// // Genode signals
+	/// _rom.sigh( reactor.on_signal( [&]() { _rom.update(); reconfigure(); } ) );
+	///
+	/// // items from worker threads, handled on the entrypoint
+	/// Csl::Reactor::Notifier results = reactor.watch( _results,
+	///                                                  [&]( Result *r ) { send( r ); } );
+	/// // in the worker: _results.enqueue( r ); results.notify();
+	/// ...
+	/// reactor.remove( results );
+	///
+	/// // timeouts
+	/// Csl::Reactor::Timeout rekey( reactor, rekey_handler );
+	/// rekey.periodic( 60 * 1000 );
+	///
+	/// \endverbatim
+	///
+	class Reactor
+	{
+		public:
+			static const unsigned MAX_BATCH = 64;
+
+			class Handler
+			{
+				public:
+					virtual void handle() = 0;
+					virtual ~Handler() {}
+			};
+
+			///
+			/// Wakes up the reactor for a watched queue, see watch().
+			///
+			class Notifier
+			{
+				private:
+					Genode::Signal_context_capability _cap;
+				public:
+					Notifier( Genode::Signal_context_capability cap ): _cap( cap ) {}
+
+					/// Tell the reactor values were enqueued. Notifications
+					/// coalesce, so call it for every enqueue.
+					void notify()
+					{
+						Genode::Signal_transmitter( _cap ).submit();
+					}
+
+					Genode::Signal_context_capability cap() const
+					{
+						return _cap;
+					}
+			};
+
+			///
+			/// Calls a handler when a point in time has passed. A timeout
+			/// is armed by once() or periodic(), and disarmed when it
+			/// fires (once), by cancel(), or by its destructor.
+			///
+			class Timeout
+			{
+				private:
+					friend class Reactor;
+
+					Reactor &_reactor;
+					Handler &_handler;
+					unsigned long _deadline_ms;
+					unsigned long _period_ms;
+					bool _armed;
+					Timeout *_next;
+
+					Timeout( const Timeout & );
+					Timeout &operator=( const Timeout & );
+
+				public:
+					Timeout( Reactor &reactor, Handler &handler ): _reactor( reactor ),
+						_handler( handler ), _deadline_ms( 0 ), _period_ms( 0 ),
+						_armed( false ), _next( nullptr ) {}
+
+					~Timeout()
+					{
+						cancel();
+					}
+
+					/// Fire once, ms milliseconds from now.
+					void once( unsigned long ms );
+
+					/// Fire every ms milliseconds, starting ms from now.
+					void periodic( unsigned long ms );
+
+					void cancel();
+
+					bool armed() const
+					{
+						return _armed;
+					}
+			};
+
+		private:
+			///
+			/// Event source with its own signal handler
+			///
+			class Source
+			{
+				private:
+					friend class Reactor;
+
+					Genode::Signal_handler<Source> _sigh;
+					Source *_next;
+
+					void _handle()
+					{
+						dispatch();
+					}
+
+					Source( const Source & );
+					Source &operator=( const Source & );
+
+				public:
+					Source( Genode::Entrypoint &ep ): _sigh( ep, *this, &Source::_handle ),
+						_next( nullptr ) {}
+
+					virtual ~Source() {}
+
+					virtual void dispatch() = 0;
+
+					Genode::Signal_context_capability cap()
+					{
+						return _sigh;
+					}
+			};
+
+			template <typename FUNC>
+			class Signal_source: public Source
+			{
+				private:
+					FUNC _func;
+				public:
+					Signal_source( Genode::Entrypoint &ep, FUNC const &func ): Source( ep ),
+						_func( func ) {}
+
+					void dispatch() override
+					{
+						_func();
+					}
+			};
+
+			template <typename QUEUE, typename FUNC>
+			class Queue_source: public Source
+			{
+				private:
+					QUEUE &_queue;
+					FUNC _func;
+					const unsigned _batch;
+				public:
+					Queue_source( Genode::Entrypoint &ep, QUEUE &queue, FUNC const &func,
+					              unsigned batch ):
+						Source( ep ), _queue( queue ), _func( func ), _batch( batch ) {}
+
+					void dispatch() override
+					{
+						typename QUEUE::Type val;
+
+						for ( unsigned i = 0; i < _batch; ++i )
+						{
+							if ( not _queue.try_dequeue( val ) )
+							{
+								return;
+							}
+
+							_func( val );
+						}
+
+						// More to do: give the other sources a turn first
+						Genode::Signal_transmitter( cap() ).submit();
+					}
+			};
+
+			class Timer_source: public Source
+			{
+				private:
+					Reactor &_reactor;
+				public:
+					Timer_source( Genode::Entrypoint &ep, Reactor &reactor ): Source( ep ),
+						_reactor( reactor ) {}
+
+					void dispatch() override
+					{
+						_reactor._expire();
+					}
+			};
+
+			Genode::Entrypoint &_ep;
+			Timer::Connection _timer;
+			Source *_sources;
+			Timer_source _timer_source;
+			Timeout *_timeouts;      // sorted by deadline
+
+			Reactor( const Reactor & );
+			Reactor &operator=( const Reactor & );
+
+			Source &_add( Source *source )
+			{
+				source->_next = _sources;
+				_sources = source;
+				return *source;
+			}
+
+			void _arm( Timeout &timeout );
+			void _disarm( Timeout &timeout );
+			void _program_timer();
+			void _expire();
+
+		public:
+			Reactor( Genode::Env &env );
+			~Reactor();
+
+			/// Call handler on the entrypoint for every signal.
+			///
+			/// \return the capability to install as signal handler.
+			///
+			template <typename FUNC>
+			typename Enable_if<not Is_base_of<Handler, FUNC>::VALUE,
+			         Genode::Signal_context_capability>::Type on_signal( FUNC const &handler )
+			{
+				return _add( new Signal_source<FUNC>( _ep, handler ) ).cap();
+			}
+
+			Genode::Signal_context_capability on_signal( Handler &handler )
+			{
+				return on_signal( [&handler]() { handler.handle(); } );
+			}
+
+			/// Handle the values of a queue on the entrypoint.
+			///
+			/// \param queue    queue with try_dequeue( Type & ), like Queue
+			///                 and Blocking_queue.
+			/// \param handler  called as handler( value ) per value.
+			/// \param batch    values handled per dispatch, before the
+			///                 other sources get a turn.
+			///
+			/// \return notifier to call after enqueueing.
+			///
+			template <typename QUEUE, typename FUNC>
+			Notifier watch( QUEUE &queue, FUNC const &handler, unsigned batch = MAX_BATCH )
+			{
+				return Notifier( _add( new Queue_source<QUEUE, FUNC>( _ep, queue, handler,
+				                                                      batch ) ).cap() );
+			}
+
+			/// Unregister the source of a signal handler from on_signal()
+			/// and dissolve the handler. Signals that are still pending
+			/// for it are dropped. Must not be called from the handler
+			/// of the source itself.
+			void remove( Genode::Signal_context_capability cap );
+
+			/// Stop watching the queue of notifier, see watch(). The
+			/// notifier must not be used anymore.
+			void remove( const Notifier &notifier )
+			{
+				remove( notifier.cap() );
+			}
+
+			/// Call f once, ms milliseconds from now. The reactor must
+			/// outlive the timeout.
+			template <typename FUNC>
+			void after( unsigned long ms, FUNC const &f )
+			{
+				struct One_shot: Handler
+				{
+					FUNC func;
+					Timeout timeout;
+
+					One_shot( Reactor &reactor, FUNC const &func ): func( func ),
+						timeout( reactor, *this ) {}
+
+					void handle() override
+					{
+						func();
+						delete this;
+					}
+				};
+
+				( new One_shot( *this, f ) )->timeout.once( ms );
+			}
+
+			/// \return milliseconds since the reactor was created.
+			unsigned long now_ms()
+			{
+				return _timer.elapsed_ms();
+			}
+	};
+} // namespace Csl
@@ -0,0 +1,205 @@
+///
+/// \file       rw_lock.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Locks for read-mostly data
+///
+
+#pragma once
+
+#include <base/lock.h>
+#include <util/string.h>
+
+#include <csl/util/thread.h>
+#include <csl/util/atomic.h>
+#include <csl/util/cache.h>
+
+namespace Csl
+{
+	///
+	/// Reader-writer lock for read-mostly data.
+	///
+	/// Readers don't take a lock: they register in one of
+	/// READER_SLOTS counters, picked per thread and each on its own
+	/// cache line, so readers on different cpus don't contend with each
+	/// other. A writer excludes other writers with a Genode::Lock, blocks
+	/// new readers, and then waits for the registered readers to leave.
+	/// Writers take precedence over new readers.
+	///
+	class Rw_lock
+	{
+		public:
+			static const unsigned READER_SLOTS = 8;
+
+		private:
+			Cache_aligned<Atomic_variable<long>> _readers[READER_SLOTS];
+			Atomic_variable<bool> _writer;
+			Genode::Lock _write_lock;
+
+			Rw_lock( const Rw_lock & );
+			Rw_lock &operator=( const Rw_lock & );
+
+			long _active_readers() const
+			{
+				long n = 0;
+
+				for ( unsigned i = 0; i < READER_SLOTS; ++i )
+				{
+					n += _readers[i]->load();
+				}
+
+				return n;
+			}
+
+		public:
+			Rw_lock(): _writer( false ) {}
+
+			/// Acquire shared (read) access.
+			///
+			/// \return the slot to pass to unlock_shared().
+			///
+			unsigned lock_shared()
+			{
+				const unsigned slot = thread_slot( READER_SLOTS );
+
+				while ( true )
+				{
+					_readers[slot]->fetch_add( 1 );
+
+					if ( not _writer.load() )
+					{
+						return slot;
+					}
+
+					// Back off, and sleep until the writer is done
+					_readers[slot]->fetch_sub( 1 );
+					_write_lock.lock();
+					_write_lock.unlock();
+				}
+			}
+
+			void unlock_shared( const unsigned slot )
+			{
+				_readers[slot]->fetch_sub( 1, Memory_order::release );
+			}
+
+			/// Acquire exclusive (write) access.
+			void lock()
+			{
+				_write_lock.lock();
+				_writer.store( true );
+
+				while ( 0 != _active_readers() )
+				{
+					cpu_relax();
+				}
+			}
+
+			void unlock()
+			{
+				_writer.store( false, Memory_order::release );
+				_write_lock.unlock();
+			}
+
+			class Read_guard
+			{
+				private:
+					Rw_lock &_lock;
+					const unsigned _slot;
+				public:
+					Read_guard( Rw_lock &lock ): _lock( lock ), _slot( lock.lock_shared() ) {}
+					~Read_guard()
+					{
+						_lock.unlock_shared( _slot );
+					}
+			};
+
+			class Write_guard
+			{
+				private:
+					Rw_lock &_lock;
+				public:
+					Write_guard( Rw_lock &lock ): _lock( lock )
+					{
+						_lock.lock();
+					}
+					~Write_guard()
+					{
+						_lock.unlock();
+					}
+			};
+	};
+
+	///
+	/// Sequence lock: writers exclude each other with a lock, readers
+	/// don't write shared memory at all. A reader copies the data and
+	/// retries when a writer was active in the meantime.
+	///
+	/// Usage by readers:
+	/// \verbatim
+	///
+	/// unsigned long seq;
+	/// do {
+	///   seq = lock.read_begin();
+	///   copy = data;
+	/// } while ( lock.read_retry( seq ) );
+	///
+	/// \endverbatim
+	///
+	class Seqlock
+	{
+		private:
+			Atomic_variable<unsigned long> _seq;
+			Genode::Lock _write_lock;
+
+			Seqlock( const Seqlock & );
+			Seqlock &operator=( const Seqlock & );
+
+		public:
+			Seqlock(): _seq( 0UL ) {}
+
+			/// \return sequence number to pass to read_retry().
+			unsigned long read_begin() const
+			{
+				while ( true )
+				{
+					const unsigned long seq = _seq.load( Memory_order::acquire );
+
+					// odd: a write is in progress
+					if ( 0 == ( seq & 1 ) )
+					{
+						return seq;
+					}
+
+					cpu_relax();
+				}
+			}
+
+			/// \return true iff the data read since read_begin() may be
+			///         inconsistent, and must be read again.
+			bool read_retry( const unsigned long seq ) const
+			{
+				atomic_thread_fence( Memory_order::acquire );
+				return _seq.load( Memory_order::relaxed ) != seq;
+			}
+
+			void write_lock()
+			{
+				_write_lock.lock();
+				_seq.store( _seq.load( Memory_order::relaxed ) + 1, Memory_order::relaxed );
+				atomic_thread_fence( Memory_order::release );
+			}
+
+			void write_unlock()
+			{
+				_seq.store( _seq.load( Memory_order::relaxed ) + 1, Memory_order::release );
+				_write_lock.unlock();
+			}
+	};
+} // namespace Csl
@@ -0,0 +1,101 @@
+///
+/// \file       sharded_counter.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Statistics counter without cache line bouncing
+///
+
+#pragma once
+
+#include <csl/util/cache.h>
+#include <csl/util/atomic.h>
+#include <csl/util/thread.h>
+
+namespace Csl
+{
+	///
+	/// Counter for statistics that are updated by many threads, and
+	/// read rarely.
+	///
+	/// Every thread adds to its own slot (see thread_slot), each on its
+	/// own cache line, and value() sums the slots. Adding is cheap and
+	/// scales with the number of cores; reading costs SLOTS loads and
+	/// is not an atomic snapshot when threads add concurrently.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Sharded_counter<> _packets;
+	/// ++_packets;                      // in every worker
+	/// report( _packets.value() );      // once in a while
+	///
+	/// \endverbatim
+	///
+	template <unsigned SLOTS = 16>
+	class Sharded_counter
+	{
+		private:
+			Cache_aligned<Atomic_variable<long>> _slots[SLOTS];
+
+			Sharded_counter( const Sharded_counter & );
+			Sharded_counter &operator=( const Sharded_counter & );
+
+		public:
+			Sharded_counter()
+			{
+				reset();
+			}
+
+			void add( const long n )
+			{
+				_slots[thread_slot( SLOTS )]->fetch_add( n, Memory_order::relaxed );
+			}
+
+			void operator++()
+			{
+				add( 1 );
+			}
+
+			void operator+=( const long n )
+			{
+				add( n );
+			}
+
+			void operator-=( const long n )
+			{
+				add( -n );
+			}
+
+			/// \return the sum of all slots.
+			long value() const
+			{
+				long sum = 0;
+
+				for ( unsigned i = 0; i < SLOTS; ++i )
+				{
+					sum += _slots[i]->load( Memory_order::relaxed );
+				}
+
+				return sum;
+			}
+
+			operator long() const
+			{
+				return value();
+			}
+
+			void reset()
+			{
+				for ( unsigned i = 0; i < SLOTS; ++i )
+				{
+					_slots[i]->store( 0, Memory_order::relaxed );
+				}
+			}
+	};
+} // namespace Csl
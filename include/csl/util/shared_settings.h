@@ -21,6 +21,7 @@
 #include <base/attached_rom_dataspace.h>
 
 #include <csl/util/assert.h>
+#include <csl/util/lock_profile.h>
 
 namespace Csl
 {
@@ -36,8 +37,8 @@ namespace Csl
 			void safe_operation( FUN accessor )
 			{
 				cslassert( _valid );
-				static Genode::Lock lock;
-				Genode::Lock_guard<Genode::Lock> guard( lock );
+				static Profiled_lock lock( "shared_settings" );
+				Profiled_lock::Guard guard( lock );
 
 				uint8_t buffer[mem().size()];
 				Genode::memcpy( buffer, mem().data(), mem().size() );
@@ -17,6 +17,7 @@
 #include <stdarg.h>
 #include <base/printf.h>
 #include <base/log.h>
+#include <base/allocator.h>
 
 #include <csl/util/stdint.h>
 #include <csl/util/hash.h>
@@ -67,11 +68,43 @@ namespace Csl
 				private:
 					size_t _capacity;
 					Type *_data;
+					Genode::Allocator *_alloc;
+
+					Type *_allocate( const size_t capacity )
+					{
+						if ( nullptr == _alloc )
+						{
+							return new Type[capacity];
+						}
+
+						void *data = nullptr;
+
+						if ( not _alloc->alloc( capacity * sizeof( Type ), &data ) )
+						{
+							throw Genode::Allocator::Out_of_memory();
+						}
+
+						return static_cast<Type *>( data );
+					}
+
+					void _release( Type *data, const size_t capacity )
+					{
+						if ( nullptr == _alloc )
+						{
+							delete[] data;
+							return;
+						}
+
+						_alloc->free( data, capacity * sizeof( Type ) );
+					}
+
 				public:
-					Storage( const size_t capacity = 1 ):
-						_capacity( 1 ), _data( nullptr )
+					Storage( const size_t capacity = 1, Genode::Allocator *alloc = nullptr ):
+						_capacity( 1 ), _data( nullptr ), _alloc( alloc )
 					{
-						guarantee( capacity );
+						// guarantee( 0 ) doesn't allocate, always reserve
+						// room for the terminating 0.
+						guarantee( capacity ? capacity : 1 );
 						nullify();
 					}
 
@@ -96,13 +129,13 @@ namespace Csl
 							new_capacity *= 2;
 						}
 
-						Type *new_data = new Type[new_capacity];
+						Type *new_data = _allocate( new_capacity );
 
 						if ( nullptr != _data )
 						{
 							Genode::memset( new_data, 0, new_capacity * sizeof( Type ) );
 							Genode::memcpy( new_data, _data, _capacity * sizeof( Type ) );
-							delete[] _data;
+							_release( _data, _capacity );
 						}
 
 						_capacity = new_capacity;
@@ -140,11 +173,12 @@ namespace Csl
 						*this = other;
 					}
 					Storage( const Storage
-					         &&other ): _capacity( other._capacity ), _data( other._data ) {}
+					         &&other ): _capacity( other._capacity ), _data( other._data ),
+						_alloc( other._alloc ) {}
 					~Storage()
 					{
-						nullify();
-						delete[] _data;
+						// Not wiped, keep secrets in a Secure_string
+						_release( _data, _capacity );
 					}
 			};
 
@@ -300,6 +334,17 @@ namespace Csl
 			Basic_string( const Type *begin ): Basic_string( begin,
 				        strlen<Type>( begin ) ) {}
 
+			/// Empty string with its characters allocated from alloc,
+			/// such as an Arena. Copies of the string use the heap.
+			explicit Basic_string( Genode::Allocator &alloc ): _storage( 1, &alloc ),
+				_length( 0 ) {}
+
+			Basic_string( const Type *begin, Genode::Allocator &alloc ):
+				_storage( strlen<Type>( begin ), &alloc ), _length( strlen<Type>( begin ) )
+			{
+				Genode::memcpy( _storage.data(), begin, sizeof( Type ) * _length );
+			}
+
 			Basic_string( const size_t s, const  Type c ): _storage( s ), _length( s )
 			{
 				for ( size_t i = 0; i < _length; ++i )
@@ -0,0 +1,406 @@
+///
+/// \file       sync.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Semaphore, event and condition variable
+///
+
+#pragma once
+
+#include <base/lock.h>
+#include <base/semaphore.h>
+
+#include <csl/util/atomic.h>
+#include <csl/util/clock.h>
+
+namespace Csl
+{
+	///
+	/// Counting semaphore.
+	///
+	/// down() first spins for a while, and only parks the thread on a
+	/// Genode::Semaphore when the count stays zero. The spin limit
+	/// adapts to how long waiting took recently, so a semaphore that
+	/// is handed over quickly doesn't pay for parking, and one that
+	/// isn't doesn't waste cycles.
+	///
+	/// The count goes negative while threads are parked; up() only
+	/// touches the Genode::Semaphore when somebody is parked.
+	///
+	class Semaphore
+	{
+		public:
+			static const long MAX_SPIN = 1024;
+
+		private:
+			Atomic_variable<long> _count;
+			Atomic_variable<long> _spin;
+			Genode::Semaphore _park;
+
+			Semaphore( const Semaphore & );
+			Semaphore &operator=( const Semaphore & );
+
+			/// Spin until a unit is taken, or the spin limit is reached.
+			bool _spin_down()
+			{
+				const long spin = _spin.load( Memory_order::relaxed );
+				const long limit = min( MAX_SPIN, 2 * spin + 16 );
+
+				for ( long i = 0; i < limit; ++i )
+				{
+					if ( try_down() )
+					{
+						_spin.store( spin + ( i - spin ) / 8, Memory_order::relaxed );
+						return true;
+					}
+
+					cpu_relax();
+				}
+
+				_spin.store( spin - spin / 8, Memory_order::relaxed );
+				return false;
+			}
+
+			static long min( const long a, const long b )
+			{
+				return a < b ? a : b;
+			}
+
+		public:
+			explicit Semaphore( const long count = 0 ): _count( count ), _spin( 0L ),
+				_park( 0 ) {}
+
+			void up()
+			{
+				if ( _count.fetch_add( 1, Memory_order::release ) < 0 )
+				{
+					_park.up();
+				}
+			}
+
+			void down()
+			{
+				if ( _spin_down() )
+				{
+					return;
+				}
+
+				if ( _count.fetch_sub( 1, Memory_order::acquire ) <= 0 )
+				{
+					_park.down();
+				}
+			}
+
+			/// Take a unit without waiting.
+			///
+			/// \return false iff the count was zero.
+			///
+			bool try_down()
+			{
+				long count = _count.load( Memory_order::relaxed );
+
+				while ( count > 0 )
+				{
+					if ( _count.compare_exchange( count, count - 1, Memory_order::acquire ) )
+					{
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			/// Take a unit, waiting at most until the deadline expires.
+			///
+			/// \return false iff the deadline expired first.
+			///
+			bool down_until( Deadline &deadline )
+			{
+				do
+				{
+					if ( _spin_down() )
+					{
+						return true;
+					}
+				}
+				while ( deadline.wait() );
+
+				return false;
+			}
+
+			/// Take a unit, waiting at most timeout_ms milliseconds.
+			///
+			/// \see down_until
+			///
+			bool down_for( unsigned long timeout_ms, Clock &clock )
+			{
+				Deadline deadline( clock, timeout_ms );
+				return down_until( deadline );
+			}
+
+			/// \return the count, negative when threads are waiting.
+			long count() const
+			{
+				return _count.load( Memory_order::relaxed );
+			}
+	};
+
+	///
+	/// Event that threads wait for.
+	///
+	/// An auto-reset event releases a single waiter per set(), and is
+	/// reset when it does. When nobody waits, the event stays set until
+	/// the next wait(), so a set() before a wait() is never lost.
+	///
+	/// A manual-reset event releases all waiters, and stays set until
+	/// reset() is called.
+	///
+	class Event
+	{
+		public:
+			enum Mode { AUTO_RESET, MANUAL_RESET };
+			static const unsigned SPIN_ROUNDS = 64;
+
+		private:
+			const Mode _mode;
+			Genode::Lock _lock;
+			bool _set;
+			unsigned _waiters;
+			Genode::Semaphore _wake;
+
+			Event( const Event & );
+			Event &operator=( const Event & );
+
+			/// \pre _lock is held
+			bool _consume()
+			{
+				if ( not _set )
+				{
+					return false;
+				}
+
+				if ( AUTO_RESET == _mode )
+				{
+					_set = false;
+				}
+
+				return true;
+			}
+
+		public:
+			explicit Event( const Mode mode = AUTO_RESET, const bool set = false ):
+				_mode( mode ), _set( set ), _waiters( 0 ), _wake( 0 ) {}
+
+			void set()
+			{
+				unsigned wake = 0;
+
+				{
+					Genode::Lock::Guard guard( _lock );
+
+					if ( MANUAL_RESET == _mode )
+					{
+						_set = true;
+						wake = _waiters;
+						_waiters = 0;
+					}
+					else if ( _waiters > 0 )
+					{
+						// Hand the event to a waiter directly
+						--_waiters;
+						wake = 1;
+					}
+					else
+					{
+						_set = true;
+					}
+				}
+
+				for ( ; wake > 0; --wake )
+				{
+					_wake.up();
+				}
+			}
+
+			void reset()
+			{
+				Genode::Lock::Guard guard( _lock );
+				_set = false;
+			}
+
+			/// \return false iff the event wasn't set. Resets an
+			///         auto-reset event that was set.
+			bool try_wait()
+			{
+				Genode::Lock::Guard guard( _lock );
+				return _consume();
+			}
+
+			void wait()
+			{
+				for ( unsigned i = 0; i < SPIN_ROUNDS; ++i )
+				{
+					if ( __atomic_load_n( &_set, __ATOMIC_RELAXED ) && try_wait() )
+					{
+						return;
+					}
+
+					cpu_relax();
+				}
+
+				{
+					Genode::Lock::Guard guard( _lock );
+
+					if ( _consume() )
+					{
+						return;
+					}
+
+					++_waiters;
+				}
+
+				_wake.down();
+			}
+
+			/// Wait, at most until the deadline expires.
+			///
+			/// \return false iff the deadline expired first.
+			///
+			bool wait_until( Deadline &deadline )
+			{
+				do
+				{
+					if ( try_wait() )
+					{
+						return true;
+					}
+				}
+				while ( deadline.wait() );
+
+				return false;
+			}
+
+			/// Wait at most timeout_ms milliseconds.
+			///
+			/// \see wait_until
+			///
+			bool wait_for( unsigned long timeout_ms, Clock &clock )
+			{
+				Deadline deadline( clock, timeout_ms );
+				return wait_until( deadline );
+			}
+	};
+
+	///
+	/// Condition variable, used with any lock that has lock() and
+	/// unlock() (Genode::Lock, Profiled_lock).
+	///
+	/// A waiter registers before it releases the lock, so a
+	/// notification sent after the waiter checked its condition under
+	/// the lock is never lost.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Genode::Lock::Guard guard( _lock );
+	/// _nonempty.wait( _lock, [&]() { return _count > 0; } );
+	///
+	/// \endverbatim
+	///
+	class Condition
+	{
+		private:
+			Genode::Lock _lock;
+			unsigned _waiters;
+			Genode::Semaphore _wake;
+
+			Condition( const Condition & );
+			Condition &operator=( const Condition & );
+
+		public:
+			Condition(): _waiters( 0 ), _wake( 0 ) {}
+
+			/// Release lock, wait for a notification, and reacquire lock.
+			/// May return without notification; check the condition.
+			///
+			/// \pre lock is held by the caller
+			///
+			template <typename LOCK>
+			void wait( LOCK &lock )
+			{
+				{
+					Genode::Lock::Guard guard( _lock );
+					++_waiters;
+				}
+
+				lock.unlock();
+				_wake.down();
+				lock.lock();
+			}
+
+			/// Wait until ready() returns true.
+			///
+			/// \pre lock is held by the caller
+			///
+			template <typename LOCK, typename FUNC>
+			void wait( LOCK &lock, FUNC const &ready )
+			{
+				while ( not ready() )
+				{
+					wait( lock );
+				}
+			}
+
+			void notify_one()
+			{
+				{
+					Genode::Lock::Guard guard( _lock );
+
+					if ( 0 == _waiters )
+					{
+						return;
+					}
+
+					--_waiters;
+				}
+
+				_wake.up();
+			}
+
+			void notify_all()
+			{
+				unsigned wake = 0;
+
+				{
+					Genode::Lock::Guard guard( _lock );
+					wake = _waiters;
+					_waiters = 0;
+				}
+
+				for ( ; wake > 0; --wake )
+				{
+					_wake.up();
+				}
+			}
+	};
+
+	///
+	/// Something that waits without blocking a thread, such as an
+	/// Async_task, and is woken up when what it waits for happens.
+	///
+	class Wakeable
+	{
+		public:
+			/// Called from any thread.
+			virtual void wake() = 0;
+
+		protected:
+			~Wakeable() {}
+	};
+} // namespace Csl
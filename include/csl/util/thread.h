@@ -15,42 +15,70 @@
 
 #include <base/lock.h>
 #include <base/thread.h>
+#include <util/construct_at.h>
 #include <csl/util/assert.h>
+#include <csl/util/atomic.h>
+#include <csl/util/clock.h>
+#include <csl/util/lock_profile.h>
+#include <csl/util/sync.h>
+#include <csl/util/cache.h>
+#include <csl/util/object_pool.h>
 
 namespace Csl
 {
 	using Genode::Lock;
 
-	using Thread = Genode::Thread_deprecated<64UL * 1024 * sizeof( long )>;
+	static const Genode::size_t DEFAULT_STACK_SIZE = 64UL * 1024 * sizeof( long );
+
+	using Thread = Genode::Thread_deprecated<DEFAULT_STACK_SIZE>;
+
+	///
+	/// Map the calling thread to one of slots. Genode has no thread
+	/// local storage, data structures that keep state per thread use
+	/// this to pick their slot instead. Different threads may share a
+	/// slot, so the slots need to be thread safe themselves.
+	///
+	/// \param slots  the number of slots.
+	///
+	/// \return slot in [0, slots).
+	///
+	inline unsigned thread_slot( const unsigned slots )
+	{
+		Genode::addr_t t = reinterpret_cast<Genode::addr_t>( Genode::Thread::myself() );
+		t = ( t >> 6 ) * 0x9e3779b1UL;
+		return ( t >> 16 ) % slots;
+	}
 
 	///
 	/// Make a thread blockable with this mixin
 	///
+	/// An unblock() that happens before the matching block() is
+	/// remembered, so the wakeup is not lost: block() then returns
+	/// immediately.
+	///
 	class Blockable
 	{
 		private:
-			Lock _lock;
+			Event _event;
 		public:
 			void block()
 			{
-				_lock.lock();
-				_lock.lock();
-				_lock.unlock();
+				_event.wait();
 			}
 
+			/// Call f, then block. Use f to hand the wakeup to another
+			/// thread, e.g. by releasing a lock.
 			template <typename FUNC>
 			void block_and( FUNC const &f )
 			{
-				_lock.lock();
 				f();
-				_lock.lock();
-				_lock.unlock();
+				_event.wait();
 			}
 
 
 			void unblock()
 			{
-				_lock.unlock();
+				_event.set();
 			}
 
 			virtual ~Blockable() {}
@@ -69,109 +97,175 @@ namespace Csl
 			};
 	};
 
+	///
+	/// Unbounded FIFO queue.
+	///
+	/// Two-lock queue (Michael & Scott, PODC 1996): enqueuers only take
+	/// the tail lock and dequeuers only the head lock, so producers and
+	/// consumers don't contend with each other. The head, the tail and
+	/// the count each live on their own cache line.
+	///
 	template <typename TYPE>
-	class Atomic_variable
+	struct Queue
 	{
+		public:
+			using Type = TYPE;
 		private:
-			TYPE _var;
-			mutable Lock _lock;
+			struct Item: Pool_allocated<Item>
+			{
+				alignas( Type ) char _val[sizeof( Type )];
+				Atomic_variable<Item *> next;
 
-			// can't copy
-			Atomic_variable &operator=( const Atomic_variable &other );
-			Atomic_variable( const Atomic_variable &other );
-		public:
-			template <typename ...ARGS>
-			Atomic_variable( const ARGS &...args ): _var( args... ) {}
+				Item(): next( nullptr ) {}
 
-			const Atomic_variable &operator=( const TYPE &var )
-			{
-				Lock::Guard guard( _lock );
-				_var = var;
-				return *this;
-			}
+				Type &val()
+				{
+					return *reinterpret_cast<Type *>( _val );
+				}
+			};
 
-			const TYPE &get() const
+			struct End
 			{
-				Lock::Guard guard( _lock );
-				return _var;
-			}
+				Profiled_lock lock;
+				Item *item;
+
+				End( Item *item ): item( item ) {}
+			};
 
-			operator TYPE() const
+			// _head.item is a dummy, the values start at its next
+			Cache_aligned<End> _head;
+			Cache_aligned<End> _tail;
+			Cache_aligned<Atomic_variable<size_t>> _count;
+
+			Queue( const Queue & );
+			Queue &operator=( const Queue & );
+
+			/// Unlink the first value. The item holding it becomes the
+			/// new dummy, the caller moves the value out of it and
+			/// deletes the old dummy.
+			///
+			/// \param dummy  receives the old dummy.
+			///
+			/// \return the item holding the value, or nullptr if the
+			///         queue was empty.
+			///
+			/// \pre the head lock is held
+			///
+			Item *_pop( Item *&dummy )
 			{
-				return get();
+				Item *first = _head->item->next.load( Memory_order::acquire );
+
+				if ( nullptr == first )
+				{
+					return nullptr;
+				}
+
+				dummy = _head->item;
+				_head->item = first;
+				_count->fetch_sub( 1, Memory_order::relaxed );
+				return first;
 			}
-	};
 
-	template <typename TYPE>
-	struct Queue
-	{
-		public:
-			using Type = TYPE;
-		private:
-			struct Item
+			/// \pre the queue is not empty
+			Type _dequeue( Item *&dummy )
 			{
-				Type val;
-				Item *next;
-				Item( const Type &val ): val( val ), next( nullptr ) {}
-			};
+				Profiled_lock::Guard guard( _head->lock );
+				Item *first = _pop( dummy );
+				cslassert( nullptr != first );
+				Type ret = first->val();
+				first->val().~Type();
+				return ret;
+			}
 
-			Item *_head;
-			Item *_tail;
-			size_t _count;
-			mutable Lock _access;
 		public:
-			Queue(): _head( nullptr ), _tail( nullptr ), _count( 0 ) {}
+			Queue(): _head( new Item() ), _tail( _head->item ), _count( size_t( 0 ) ) {}
 
 			void enqueue( const Type val )
 			{
-				Lock::Guard guard( _access );
-				Item *i = new Item( val );
+				Item *i = new Item();
+				Genode::construct_at<Type>( i->_val, val );
 
-				if ( 0 == _count )
-				{
-					_head = _tail = i;
-				}
-				else
-				{
-					_tail->next = i;
-					_tail = i;
-				}
+				// Count first, so size() never underestimates
+				_count->fetch_add( 1, Memory_order::relaxed );
 
-				_count++;
+				Profiled_lock::Guard guard( _tail->lock );
+				_tail->item->next.store( i, Memory_order::release );
+				_tail->item = i;
 			}
 
+			/// \return the number of values, may be outdated as soon as
+			///         it is returned.
 			size_t size() const
 			{
-				Lock::Guard guard( _access );
-				return _count;
+				return _count->load( Memory_order::relaxed );
 			}
 
 			const Type dequeue()
 			{
-				Lock::Guard guard( _access );
-				cslassert( 0 < _count );
-				Type ret = _head->val;
-				Item *oldhead = _head;
-				_head = _head->next;
-				delete oldhead;
-				_count--;
+				Item *dummy = nullptr;
+				const Type ret = _dequeue( dummy );
+				delete dummy;
 				return ret;
 			}
 
-			~Queue()
+			/// Dequeue without asserting the queue is non-empty.
+			///
+			/// \param val  receives the dequeued value.
+			///
+			/// \return false iff the queue was empty.
+			///
+			bool try_dequeue( Type &val )
 			{
-				Lock::Guard guard( _access );
+				Item *dummy = nullptr;
 
-				for ( Item *i = _head; nullptr != i; )
 				{
-					Item *old = i;
-					i = i->next;
-					delete old;
+					Profiled_lock::Guard guard( _head->lock );
+					Item *first = _pop( dummy );
+
+					if ( nullptr == first )
+					{
+						return false;
+					}
+
+					val = first->val();
+					first->val().~Type();
 				}
 
+				delete dummy;
+				return true;
+			}
+
+			/// Name the locks in the lock profile.
+			void lock_name( const char *name )
+			{
+				_head->lock.name( name );
+				_tail->lock.name( name );
+			}
+
+			~Queue()
+			{
+				Profiled_lock::Guard guard( _head->lock );
+				Item *i = _head->item;
+				Item *next = i->next.load();
+				delete i;
+
+				for ( i = next; nullptr != i; i = next )
+				{
+					next = i->next.load();
+					i->val().~Type();
+					delete i;
+				}
 			}
 	};
 
+	///
+	/// Bounded queue, dequeue() blocks while the queue is empty and
+	/// enqueue() blocks while it holds MAX values.
+	///
+	/// Producers and consumers hand over through two Semaphores, one
+	/// counting the values and one counting the free places, so
+	/// neither side ever misses a wakeup.
+	///
 	template <typename TYPE, size_t MAX = 10>
 	class Blocking_queue
 	{
@@ -179,66 +273,276 @@ namespace Csl
 			using Type = TYPE;
 		private:
 			Queue<Type> _queue;
-			Lock _access;
-			Blockable _consumer, _producer;
+			Semaphore _items;
+			Semaphore _slots;
 		public:
+			Blocking_queue(): _items( 0 ), _slots( MAX ) {}
+
 			const Type dequeue()
 			{
-				Lock::Guard guard( _access );
+				_items.down();
+				const Type ret = _queue.dequeue();
+				_slots.up();
+				return ret;
+			}
+
+			void enqueue( const Type &val )
+			{
+				_slots.down();
+				_queue.enqueue( val );
+				_items.up();
+			}
 
-				if ( 0 == _queue.size() )
+			/// Dequeue without blocking.
+			///
+			/// \param val  receives the dequeued value.
+			///
+			/// \return false iff the queue was empty.
+			///
+			bool try_dequeue( Type &val )
+			{
+				if ( not _items.try_down() )
 				{
-					_consumer.block_and( [&]()
-					{
-						_access.unlock();
-					} );
-					// Allow the producer to add some data and for the lock again
-					_access.lock();
+					return false;
 				}
 
-				_producer.unblock();
-				return _queue.dequeue();
+				val = _queue.dequeue();
+				_slots.up();
+				return true;
 			}
 
-			void enqueue( const Type &val )
+			/// Enqueue without blocking.
+			///
+			/// \param val  value to enqueue.
+			///
+			/// \return false iff the queue was full.
+			///
+			bool try_enqueue( const Type &val )
+			{
+				if ( not _slots.try_down() )
+				{
+					return false;
+				}
+
+				_queue.enqueue( val );
+				_items.up();
+				return true;
+			}
+
+			/// Name the lock in the lock profile.
+			void lock_name( const char *name )
 			{
-				Lock::Guard guard( _access );
+				_queue.lock_name( name );
+			}
 
-				if ( _queue.size() == MAX )
+			/// Dequeue, waiting at most until the deadline expires.
+			///
+			/// \return false iff the deadline expired before a value
+			///         became available.
+			///
+			bool dequeue_until( Type &val, Deadline &deadline )
+			{
+				if ( not _items.down_until( deadline ) )
 				{
-					_producer.block_and( [&]()
-					{
-						_access.unlock();
-					} );
-					_access.lock();
+					return false;
+				}
+
+				val = _queue.dequeue();
+				_slots.up();
+				return true;
+			}
+
+			/// Enqueue, waiting at most until the deadline expires.
+			///
+			/// \return false iff the deadline expired before space
+			///         became available.
+			///
+			bool enqueue_until( const Type &val, Deadline &deadline )
+			{
+				if ( not _slots.down_until( deadline ) )
+				{
+					return false;
 				}
 
 				_queue.enqueue( val );
-				_consumer.unblock();
+				_items.up();
+				return true;
+			}
+
+			/// Dequeue, waiting at most timeout_ms milliseconds.
+			///
+			/// \see dequeue_until
+			///
+			bool dequeue_for( Type &val, unsigned long timeout_ms, Clock &clock )
+			{
+				Deadline deadline( clock, timeout_ms );
+				return dequeue_until( val, deadline );
+			}
+
+			/// Enqueue, waiting at most timeout_ms milliseconds.
+			///
+			/// \see enqueue_until
+			///
+			bool enqueue_for( const Type &val, unsigned long timeout_ms, Clock &clock )
+			{
+				Deadline deadline( clock, timeout_ms );
+				return enqueue_until( val, deadline );
+			}
+
+			/// \return the number of values in the queue.
+			size_t size() const
+			{
+				return _queue.size();
 			}
 	};
 
+	///
+	/// Request/response channel between client threads and a single
+	/// server thread.
+	///
+	/// Requests are numbered, so a reply that arrives after its
+	/// submitter gave up (see submit_for) is recognized as stale and
+	/// dropped instead of being handed to the next submitter.
+	///
 	template <typename REPLY, typename MESSAGE>
 	class Channel
 	{
 		private:
-			Blocking_queue<MESSAGE,1> messages;
-			Blocking_queue<REPLY,1> replies;
-			Lock _access;
+			template <typename T>
+			struct Envelope
+			{
+				unsigned long seq;
+				T val;
+				Envelope( unsigned long seq, const T &val ): seq( seq ), val( val ) {}
+			};
+
+			Blocking_queue<Envelope<MESSAGE>,1> messages;
+			Blocking_queue<Envelope<REPLY>,1> replies;
+
+			/// A submitter owns the channel while it holds the turn.
+			Semaphore _turn;
+
+			/// Sequence number of the next request, owned by the
+			/// holder of the turn.
+			unsigned long _next;
+
+			/// Sequence number of the request the server works on.
+			unsigned long _current;
 		public:
+			Channel(): _turn( 1 ), _next( 0 ), _current( 0 ) {}
+
 			const REPLY submit( const MESSAGE &message )
 			{
-				messages.enqueue( message );
-				return replies.dequeue();
+				_turn.down();
+				const unsigned long seq = _next++;
+				messages.enqueue( Envelope<MESSAGE>( seq, message ) );
+
+				while ( true )
+				{
+					const Envelope<REPLY> reply = replies.dequeue();
+
+					if ( reply.seq == seq )
+					{
+						_turn.up();
+						return reply.val;
+					}
+				}
+			}
+
+			/// Submit a message, and wait at most timeout_ms milliseconds
+			/// for the reply.
+			///
+			/// \param message     message to submit.
+			/// \param reply       receives the reply.
+			/// \param timeout_ms  maximum time spent in this call.
+			/// \param clock       time source.
+			///
+			/// \return false iff the call timed out. The message may or
+			///         may not have been processed by the server.
+			///
+			bool submit_for( const MESSAGE &message, REPLY &reply,
+			                 unsigned long timeout_ms, Clock &clock )
+			{
+				Deadline deadline( clock, timeout_ms );
+
+				if ( not _turn.down_until( deadline ) )
+				{
+					return false;
+				}
+
+				const unsigned long seq = _next;
+
+				if ( not messages.enqueue_until( Envelope<MESSAGE>( seq, message ), deadline ) )
+				{
+					_turn.up();
+					return false;
+				}
+
+				++_next;
+
+				Envelope<REPLY> r( seq, reply );
+
+				while ( replies.dequeue_until( r, deadline ) )
+				{
+					if ( r.seq == seq )
+					{
+						reply = r.val;
+						_turn.up();
+						return true;
+					}
+				}
+
+				// The late reply to seq is dropped by the next submitter.
+				_turn.up();
+				return false;
 			}
 
 			const MESSAGE get()
 			{
-				return messages.dequeue();
+				const Envelope<MESSAGE> message = messages.dequeue();
+				_current = message.seq;
+				return message.val;
+			}
+
+			/// Get a message without blocking.
+			///
+			/// \return false iff no message was pending.
+			///
+			bool try_get( MESSAGE &message )
+			{
+				Envelope<MESSAGE> m( 0, message );
+
+				if ( not messages.try_dequeue( m ) )
+				{
+					return false;
+				}
+
+				_current = m.seq;
+				message = m.val;
+				return true;
+			}
+
+			/// Get a message, waiting at most timeout_ms milliseconds.
+			///
+			/// \return false iff no message arrived in time.
+			///
+			bool get_for( MESSAGE &message, unsigned long timeout_ms, Clock &clock )
+			{
+				Envelope<MESSAGE> m( 0, message );
+
+				if ( not messages.dequeue_for( m, timeout_ms, clock ) )
+				{
+					return false;
+				}
+
+				_current = m.seq;
+				message = m.val;
+				return true;
 			}
+
 			void put( const REPLY &reply )
 			{
-				replies.enqueue( reply );
+				replies.enqueue( Envelope<REPLY>( _current, reply ) );
 			}
 
 			template <typename FUNC>
@@ -0,0 +1,149 @@
+///
+/// \file       thread_config.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Thread affinity, priority and stack size from the config
+///
+
+#pragma once
+
+#include <base/env.h>
+#include <base/thread.h>
+#include <base/affinity.h>
+#include <cpu_session/connection.h>
+#include <util/xml_node.h>
+
+#include <csl/util/thread.h>
+#include <csl/util/list.h>
+#include <csl/util/string.h>
+
+namespace Csl
+{
+	///
+	/// Creates threads with the cpu, priority and stack size configured
+	/// for their name.
+	///
+	/// Sample configuration:
+	///
+	/// .... snipped enclosing genode config ...
+	/// <csl>
+	///   <threads>
+	///     <thread name="rx"      cpu="1" prio="0" stack="128K"/>
+	///     <thread name="crypto"  cpu="2"/>
+	///     <thread name="pool.0"  cpu="3"/>
+	///   </threads>
+	/// </csl>
+	/// .... snipped enclosing genode config ...
+	///
+	/// cpu is an index in the affinity space of the component, prio a
+	/// Genode priority (0 is the highest the component may use), and
+	/// stack a size in bytes with an optional K, M or G suffix. Threads
+	/// without configuration, and attributes that are left out, get
+	/// the defaults: no affinity, the priority of the component and
+	/// DEFAULT_STACK_SIZE.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// struct Rx_thread: Csl::Configured_thread {
+	///   Rx_thread( Csl::Thread_factory &f ): Configured_thread( f, "rx" ) {}
+	///   void entry() override { ... }
+	/// };
+	///
+	/// Csl::Thread_factory threads( env, config.xml() );
+	/// Rx_thread rx( threads );
+	/// rx.start();
+	///
+	/// \endverbatim
+	///
+	class Thread_factory
+	{
+		public:
+			/// Priority of threads that don't configure one.
+			static const long INHERIT_PRIORITY = -1;
+
+			struct Settings
+			{
+				Genode::Affinity::Location location;
+				Genode::size_t stack_size;
+				long priority;
+
+				Settings(): location(), stack_size( DEFAULT_STACK_SIZE ),
+					priority( INHERIT_PRIORITY ) {}
+			};
+
+		private:
+			struct Entry
+			{
+				string name;
+				Settings settings;
+			};
+
+			struct Cpu
+			{
+				const long priority;
+				Genode::Cpu_connection connection;
+				Cpu *next;
+
+				Cpu( Genode::Env &env, long priority, Cpu *next ):
+					priority( priority ),
+					connection( env, "csl threads", priority ),
+					next( next )
+				{}
+			};
+
+			Genode::Env &_env;
+			List<Entry> _entries;
+			Cpu *_cpus;
+			Genode::Lock _cpus_lock;
+
+			Thread_factory( const Thread_factory & );
+			Thread_factory &operator=( const Thread_factory & );
+
+			void _parse( const Genode::Xml_node &thread );
+
+		public:
+			/// Constructor
+			///
+			/// \param env     the environment
+			/// \param config  root of the config, the <csl> node is
+			///                looked up below it as init_logging does.
+			///
+			Thread_factory( Genode::Env &env, const Genode::Xml_node &config );
+
+			~Thread_factory();
+
+			/// \return the settings for the thread called name.
+			Settings settings( const char *name ) const;
+
+			/// \return the cpu session to create the thread called name
+			///         with, which determines its priority.
+			Genode::Cpu_session &cpu( const char *name );
+
+			Genode::Env &env()
+			{
+				return _env;
+			}
+	};
+
+	///
+	/// Thread configured by a Thread_factory, use it instead of
+	/// Csl::Thread or Genode::Thread as base class.
+	///
+	class Configured_thread: public Genode::Thread
+	{
+		public:
+			Configured_thread( Thread_factory &factory, const char *name ):
+				Genode::Thread( factory.env(), name,
+				                factory.settings( name ).stack_size,
+				                factory.settings( name ).location,
+				                Weight(), factory.cpu( name ) )
+			{}
+	};
+} // namespace Csl
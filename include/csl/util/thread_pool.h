@@ -0,0 +1,385 @@
+///
+/// \file       thread_pool.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Work-stealing thread pool
+///
+
+#pragma once
+
+#include <base/env.h>
+#include <base/semaphore.h>
+#include <base/affinity.h>
+
+#include <csl/util/thread.h>
+#include <csl/util/atomic.h>
+#include <csl/util/type_traits.h>
+#include <csl/util/cache.h>
+
+namespace Csl
+{
+	///
+	/// Unit of work executed by a Thread_pool.
+	///
+	class Task
+	{
+		public:
+			/// Exceptions thrown by execute() are logged by the pool, and
+			/// the task counts as done.
+			virtual void execute() = 0;
+
+			/// Called instead of execute() for a task that is still
+			/// pending when the pool is destroyed. Tasks the pool owns
+			/// free themselves, tasks owned by the caller do nothing.
+			virtual void discard() {}
+
+			virtual ~Task() {}
+	};
+
+	///
+	/// Chase-Lev work-stealing deque of tasks.
+	///
+	/// The owning thread pushes and pops tasks at the bottom, other
+	/// threads steal from the top. Only steal() may be called by
+	/// threads other than the owner.
+	///
+	/// See: "Correct and Efficient Work-Stealing for Weak Memory
+	/// Models", N.M. Le et al., PPoPP 2013.
+	///
+	/// \param CAPACITY  maximum number of tasks, must be a power of two.
+	///
+	template <size_t CAPACITY = 1024>
+	class Work_stealing_deque
+	{
+		private:
+			static_assert( CAPACITY && !( CAPACITY & ( CAPACITY - 1 ) ),
+			               "CAPACITY must be a power of two" );
+
+			static const long MASK = CAPACITY - 1;
+
+			// top is written by thieves, bottom by the owner: keep them
+			// on separate cache lines.
+			Cache_aligned<Atomic_variable<long>> _top;
+			Cache_aligned<Atomic_variable<long>> _bottom;
+			Atomic_variable<Task *> _tasks[CAPACITY];
+
+		public:
+			Work_stealing_deque(): _top( 0L ), _bottom( 0L ) {}
+
+			/// Push a task, owner only.
+			///
+			/// \return false iff the deque is full.
+			///
+			bool push( Task *task )
+			{
+				const long b = _bottom->load( Memory_order::relaxed );
+				const long t = _top->load( Memory_order::acquire );
+
+				if ( b - t >= long( CAPACITY ) )
+				{
+					return false;
+				}
+
+				_tasks[b & MASK].store( task, Memory_order::relaxed );
+				atomic_thread_fence( Memory_order::release );
+				_bottom->store( b + 1, Memory_order::relaxed );
+				return true;
+			}
+
+			/// Pop the most recently pushed task, owner only.
+			///
+			/// \return the task, or nullptr if the deque is empty.
+			///
+			Task *pop()
+			{
+				const long b = _bottom->load( Memory_order::relaxed ) - 1;
+				_bottom->store( b, Memory_order::relaxed );
+				atomic_thread_fence( Memory_order::seq_cst );
+				long t = _top->load( Memory_order::relaxed );
+
+				if ( t > b )
+				{
+					_bottom->store( b + 1, Memory_order::relaxed );
+					return nullptr;
+				}
+
+				Task *task = _tasks[b & MASK].load( Memory_order::relaxed );
+
+				if ( t == b )
+				{
+					// Last task, race against the thieves
+					if ( not _top->compare_exchange( t, t + 1, Memory_order::seq_cst ) )
+					{
+						task = nullptr;
+					}
+
+					_bottom->store( b + 1, Memory_order::relaxed );
+				}
+
+				return task;
+			}
+
+			/// Steal the least recently pushed task.
+			///
+			/// \return the task, or nullptr if the deque is empty or
+			///         another thread won the race for the task.
+			///
+			Task *steal()
+			{
+				long t = _top->load( Memory_order::acquire );
+				atomic_thread_fence( Memory_order::seq_cst );
+				const long b = _bottom->load( Memory_order::acquire );
+
+				if ( t >= b )
+				{
+					return nullptr;
+				}
+
+				Task *task = _tasks[t & MASK].load( Memory_order::relaxed );
+
+				if ( not _top->compare_exchange( t, t + 1, Memory_order::seq_cst ) )
+				{
+					return nullptr;
+				}
+
+				return task;
+			}
+
+			/// \return an estimate of the number of tasks.
+			long size() const
+			{
+				const long n = _bottom->load( Memory_order::relaxed ) - _top->load(
+				                   Memory_order::relaxed );
+				return n < 0 ? 0 : n;
+			}
+	};
+
+	///
+	/// Pool of worker threads executing Tasks.
+	///
+	/// Every worker owns a Work_stealing_deque. Tasks submitted by a
+	/// worker go to its own deque, tasks submitted by other threads go
+	/// to a shared queue. Idle workers steal from the others before
+	/// they go to sleep.
+	///
+	/// Example:
+	/// \verbatim
+	///
+	/// Csl::Thread_pool pool( env );     // one worker per cpu
+	/// pool.submit( [&]() { hash( part1 ); } );
+	/// pool.submit( [&]() { hash( part2 ); } );
+	/// pool.wait_idle();
+	///
+	/// \endverbatim
+	///
+	class Thread_pool
+	{
+		public:
+			static const size_t DEQUE_CAPACITY = 1024;
+			static const unsigned SPIN_ROUNDS = 64;
+
+		private:
+			///
+			/// Threads announce they go to sleep, then check their
+			/// condition once more before they actually sleep. Wakers
+			/// change the condition, then wake the announced sleepers.
+			///
+			class Parking
+			{
+				private:
+					Atomic_variable<unsigned> _waiting;
+					Genode::Semaphore _sleep;
+
+					bool _take_waiter()
+					{
+						// order the waker's update of the condition before
+						// reading _waiting
+						atomic_thread_fence( Memory_order::seq_cst );
+						unsigned w = _waiting.load();
+
+						while ( w > 0 )
+						{
+							if ( _waiting.compare_exchange( w, w - 1 ) )
+							{
+								return true;
+							}
+						}
+
+						return false;
+					}
+
+				public:
+					Parking(): _waiting( 0U ), _sleep( 0 ) {}
+
+					template <typename FUNC>
+					void park_unless( FUNC const &ready )
+					{
+						_waiting.fetch_add( 1 );
+						atomic_thread_fence( Memory_order::seq_cst );
+
+						if ( ready() )
+						{
+							// Retract the announcement, or swallow the
+							// wakeup somebody already sent us.
+							if ( not _take_waiter() )
+							{
+								_sleep.down();
+							}
+
+							return;
+						}
+
+						_sleep.down();
+					}
+
+					void wake_one()
+					{
+						if ( _take_waiter() )
+						{
+							_sleep.up();
+						}
+					}
+
+					void wake_all()
+					{
+						atomic_thread_fence( Memory_order::seq_cst );
+
+						for ( unsigned n = _waiting.exchange( 0 ); n > 0; --n )
+						{
+							_sleep.up();
+						}
+					}
+			};
+
+			template <typename FUNC>
+			class Function_task: public Task
+			{
+				private:
+					FUNC _func;
+				public:
+					Function_task( FUNC const &func ): _func( func ) {}
+
+					void execute() override
+					{
+						try
+						{
+							_func();
+						}
+						catch ( ... )
+						{
+							delete this;
+							throw;
+						}
+
+						delete this;
+					}
+
+					void discard() override
+					{
+						delete this;
+					}
+			};
+
+			class Worker: public Genode::Thread
+			{
+				private:
+					Thread_pool &_pool;
+				public:
+					const unsigned index;
+					Work_stealing_deque<DEQUE_CAPACITY> deque;
+
+					Worker( Genode::Env &env, Thread_pool &pool, unsigned index,
+					        const char *name, Genode::Affinity::Location location );
+
+					void entry() override;
+			};
+
+			Genode::Env &_env;
+			const unsigned _count;
+			Worker **_workers;
+			Queue<Task *> _shared;
+			Atomic_variable<long> _pending;
+			Atomic_variable<bool> _stop;
+			Parking _workers_parked;
+			Parking _idle_parked;
+
+			Thread_pool( const Thread_pool & );
+			Thread_pool &operator=( const Thread_pool & );
+
+			Worker *_current_worker() const;
+			Task *_find_work( Worker *self );
+			bool _has_work() const;
+			void _execute( Task *task );
+			void _run( Worker &self );
+
+		public:
+			/// Constructor
+			///
+			/// \param env       the environment
+			/// \param workers   number of worker threads, 0 starts one worker
+			///                  per cpu in the affinity space.
+			/// \param location  cpus to spread the workers over, round robin.
+			///                  An invalid location (the default) uses the
+			///                  whole affinity space.
+			/// \param name      name prefix of the worker threads.
+			///
+			Thread_pool( Genode::Env &env, unsigned workers = 0,
+			             Genode::Affinity::Location location = Genode::Affinity::Location(),
+			             const char *name = "pool" );
+
+			/// Stops the workers. Tasks that did not start yet are not
+			/// executed but discarded, call wait_idle() first when that
+			/// matters.
+			~Thread_pool();
+
+			/// Submit a task. The task should stay valid until it has been
+			/// executed.
+			void submit( Task &task );
+
+			/// Submit a function object (e.g. a lambda) as a task. The
+			/// function object is copied.
+			template <typename FUNC>
+			typename Enable_if<not Is_base_of<Task, FUNC>::VALUE>::Type submit(
+			    FUNC const &func )
+			{
+				submit( *new Function_task<FUNC>( func ) );
+			}
+
+			/// Submit a task behind the tasks that are already pending,
+			/// also when called from a worker. Use it to retry a task
+			/// that can't make progress yet without starving the tasks
+			/// it waits for.
+			void defer( Task &task );
+
+			/// Defer a function object (e.g. a lambda) as a task. The
+			/// function object is copied.
+			template <typename FUNC>
+			typename Enable_if<not Is_base_of<Task, FUNC>::VALUE>::Type defer(
+			    FUNC const &func )
+			{
+				defer( *new Function_task<FUNC>( func ) );
+			}
+
+			/// Block until all submitted tasks have been executed. When
+			/// called from a worker, the worker keeps executing tasks
+			/// while it waits.
+			void wait_idle();
+
+			/// Execute one pending task in the calling thread, if any.
+			///
+			/// \return false iff no task was available.
+			///
+			bool help();
+
+			unsigned workers() const
+			{
+				return _count;
+			}
+	};
+} // namespace Csl
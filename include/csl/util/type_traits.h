@@ -0,0 +1,84 @@
+///
+/// \file       type_traits.h
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Subset of the std type traits, to replace STL.
+///
+
+#pragma once
+
+namespace Csl
+{
+	template <bool CONDITION, typename T = void>
+	struct Enable_if {};
+
+	template <typename T>
+	struct Enable_if<true, T>
+	{
+		using Type = T;
+	};
+
+	template <typename A, typename B>
+	struct Is_same
+	{
+		static constexpr bool VALUE = false;
+	};
+
+	template <typename A>
+	struct Is_same<A, A>
+	{
+		static constexpr bool VALUE = true;
+	};
+
+	template <typename T> struct Remove_cv { using Type = T; };
+	template <typename T> struct Remove_cv<const T> { using Type = T; };
+	template <typename T> struct Remove_cv<volatile T> { using Type = T; };
+	template <typename T> struct Remove_cv<const volatile T> { using Type = T; };
+
+	template <typename T> struct _Is_integral { static constexpr bool VALUE = false; };
+	template <> struct _Is_integral<bool> { static constexpr bool VALUE = true; };
+	template <> struct _Is_integral<char> { static constexpr bool VALUE = true; };
+	template <> struct _Is_integral<signed char> { static constexpr bool VALUE = true; };
+	template <> struct _Is_integral<unsigned char> { static constexpr bool VALUE = true; };
+	template <> struct _Is_integral<short> { static constexpr bool VALUE = true; };
+	template <> struct _Is_integral<unsigned short> { static constexpr bool VALUE = true; };
+	template <> struct _Is_integral<int> { static constexpr bool VALUE = true; };
+	template <> struct _Is_integral<unsigned int> { static constexpr bool VALUE = true; };
+	template <> struct _Is_integral<long> { static constexpr bool VALUE = true; };
+	template <> struct _Is_integral<unsigned long> { static constexpr bool VALUE = true; };
+	template <> struct _Is_integral<long long> { static constexpr bool VALUE = true; };
+	template <> struct _Is_integral<unsigned long long> { static constexpr bool VALUE = true; };
+
+	template <typename T>
+	struct Is_integral: _Is_integral<typename Remove_cv<T>::Type> {};
+
+	template <typename T> struct Is_pointer { static constexpr bool VALUE = false; };
+	template <typename T> struct Is_pointer<T *> { static constexpr bool VALUE = true; };
+	template <typename T> struct Is_pointer<T *const> { static constexpr bool VALUE = true; };
+
+	/// Types that can be copied with memcpy, relies on the compiler builtin.
+	template <typename T>
+	struct Is_trivially_copyable
+	{
+		static constexpr bool VALUE = __is_trivially_copyable( T );
+	};
+
+	template <typename T>
+	struct Is_enum
+	{
+		static constexpr bool VALUE = __is_enum( T );
+	};
+
+	/// True iff DERIVED is BASE, or is derived from BASE.
+	template <typename BASE, typename DERIVED>
+	struct Is_base_of
+	{
+		static constexpr bool VALUE = __is_base_of( BASE, DERIVED );
+	};
+}
@@ -1,2 +1,5 @@
 INC_DIR += $(REPO_DIR)/include/
 
+# Record lock contention, see csl/util/lock_profile.h. Profiled_lock
+# changes its layout, so the library and its users must agree on it.
+#CC_OPT += -DCSL_LOCK_PROFILE
@@ -1,9 +1,15 @@
+include $(REP_DIR)/lib/import/import-libcsl.mk
+
 INC_DIR += $(REP_DIR)/include/libcsl
 
 SRC_CC =  $(notdir $(wildcard $(REP_DIR)/src/csl/*/*.cc))
 
 LIBS = jitterentropy net base
 CC_OPT += -std=c++11 
+# Let delete pass the size to the slab allocator, see csl/util/alloc.h
+CC_OPT += -fsized-deallocation
+# Count allocations, see csl/util/alloc.h
+#CC_OPT += -DCSL_ALLOC_STATS
 #-Wno-deprecated -Wno-deprecated-declarations
 SHARED_LIB =  YES
 
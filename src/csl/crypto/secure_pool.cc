@@ -0,0 +1,202 @@
+///
+/// \file       csl/crypto/secure_pool.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Separate memory pool for key material
+///
+#include <csl/crypto/secure_pool.h>
+
+#include <base/lock_guard.h>
+#include <util/construct_at.h>
+
+namespace Csl
+{
+	void secure_wipe( void *p, const size_t size )
+	{
+		Genode::memset( p, 0, size );
+
+		// The memory counts as read, so the memset can't be elided
+		asm volatile( "" : : "r"( p ) : "memory" );
+	}
+
+	Secure_pool::Secure_pool( Genode::Env &env ):
+		_ram( env.ram() ),
+		_rm( env.rm() ),
+		_chunk_count( 0 ),
+		_chunks_used( 0 ),
+		_top( nullptr ),
+		_end( nullptr ),
+		_consumed( 0 )
+	{
+		for ( unsigned c = 0; c < CLASSES; ++c )
+		{
+			_free[c] = nullptr;
+		}
+	}
+
+	Secure_pool::~Secure_pool()
+	{
+		wipe();
+
+		for ( unsigned i = 0; i < _chunk_count; ++i )
+		{
+			_rm.detach( _chunks[i].base );
+			_ram.free( _chunks[i].ds );
+		}
+	}
+
+	unsigned Secure_pool::_class_of( const size_t size )
+	{
+		unsigned c = 0;
+
+		while ( class_size( c ) < size )
+		{
+			++c;
+		}
+
+		return c;
+	}
+
+	bool Secure_pool::_grow( const size_t size )
+	{
+		// The rest of the current chunk is lost until wipe()
+		if ( _chunks_used < _chunk_count )
+		{
+			// chunks are at least CHUNK_SIZE, so any block fits
+			Chunk &chunk = _chunks[_chunks_used++];
+			_top = chunk.base;
+			_end = chunk.base + chunk.size;
+			return true;
+		}
+
+		if ( MAX_CHUNKS == _chunk_count )
+		{
+			return false;
+		}
+
+		Chunk &chunk = _chunks[_chunk_count];
+		chunk.size = size < CHUNK_SIZE ? CHUNK_SIZE : size;
+
+		try
+		{
+			chunk.ds = _ram.alloc( chunk.size );
+		}
+		catch ( ... )
+		{
+			return false;
+		}
+
+		try
+		{
+			chunk.base = _rm.attach( chunk.ds );
+		}
+		catch ( ... )
+		{
+			_ram.free( chunk.ds );
+			return false;
+		}
+
+		_chunks_used = ++_chunk_count;
+		_top = chunk.base;
+		_end = chunk.base + chunk.size;
+		return true;
+	}
+
+	bool Secure_pool::alloc( const size_t size, void **out_addr )
+	{
+		if ( size > class_size( CLASSES - 1 ) )
+		{
+			return false;
+		}
+
+		const unsigned c = _class_of( size );
+		const size_t block = class_size( c );
+		Genode::Lock_guard<Genode::Lock> guard( _lock );
+
+		if ( nullptr != _free[c] )
+		{
+			Free_block *b = _free[c];
+			_free[c] = b->next;
+			b->next = nullptr;
+			*out_addr = b;
+		}
+		else
+		{
+			if ( size_t( _end - _top ) < block && not _grow( block ) )
+			{
+				return false;
+			}
+
+			*out_addr = _top;
+			_top += block;
+		}
+
+		_consumed += block;
+		return true;
+	}
+
+	void Secure_pool::free( void *p, const size_t size )
+	{
+		const unsigned c = _class_of( size );
+		secure_wipe( p, class_size( c ) );
+
+		Genode::Lock_guard<Genode::Lock> guard( _lock );
+		Free_block *b = static_cast<Free_block *>( p );
+		b->next = _free[c];
+		_free[c] = b;
+		_consumed -= class_size( c );
+	}
+
+	void Secure_pool::wipe()
+	{
+		Genode::Lock_guard<Genode::Lock> guard( _lock );
+
+		for ( unsigned i = 0; i < _chunk_count; ++i )
+		{
+			secure_wipe( _chunks[i].base, _chunks[i].size );
+		}
+
+		for ( unsigned c = 0; c < CLASSES; ++c )
+		{
+			_free[c] = nullptr;
+		}
+
+		// Start over, _grow() hands out the chunks again in order
+		_chunks_used = 0;
+		_top = nullptr;
+		_end = nullptr;
+		_consumed = 0;
+	}
+
+	static Secure_pool *&secure_pool()
+	{
+		static Secure_pool *pool = nullptr;
+		return pool;
+	}
+
+	Secure_pool &Secure_pool::instance()
+	{
+		if ( nullptr == secure_pool() )
+		{
+			fthrow<Exception>( "Secure pool used before init_secure_pool()" );
+		}
+
+		return *secure_pool();
+	}
+
+	void init_secure_pool( Genode::Env &env )
+	{
+		static char storage[sizeof( Secure_pool )] alignas( Secure_pool );
+
+		if ( nullptr == secure_pool() )
+		{
+			secure_pool() = Genode::construct_at<Secure_pool>( storage, env );
+		}
+	}
+} // namespace Csl
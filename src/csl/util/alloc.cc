@@ -12,29 +12,617 @@
 ///
 
 #include <base/env.h>
+#include <base/heap.h>
+#include <base/lock_guard.h>
+#include <util/construct_at.h>
+
+#include <csl/util/alloc.h>
+#include <csl/util/thread.h>
 #include <csl/util/stdint.h>
 
 struct bad_alloc {};
 
 using Csl::size_t;
 
-void *operator new( size_t n ) throw( bad_alloc )
+namespace Csl
 {
-	void *ret;
-	Genode::env()->heap()->alloc( n, &ret );
+	Large_allocator::Large_allocator( Genode::Env &env ):
+		_ram( env.ram() ),
+		_rm( env.rm() ),
+		_cache( nullptr ),
+		_cached( 0 ),
+		_cached_bytes( 0 )
+	{}
 
-	if ( nullptr == ret )
+	Large_allocator::~Large_allocator()
 	{
-		throw bad_alloc();
+		flush();
 	}
 
-	return ret;
-}
+	Large_allocator::Block *Large_allocator::_from_cache( const size_t size )
+	{
+		Genode::Lock_guard<Genode::Lock> guard( _lock );
 
-void *operator new[]( size_t n ) throw( bad_alloc )
+		// Reuse a dataspace that isn't more than twice the size
+		for ( Block **b = &_cache; nullptr != *b; b = &( *b )->next )
+		{
+			Block *block = *b;
+
+			if ( block->size >= size && block->size / 2 <= size )
+			{
+				*b = block->next;
+				--_cached;
+				_cached_bytes -= block->size;
+				return block;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void Large_allocator::_release( Block *block )
+	{
+		Genode::Ram_dataspace_capability ds = block->ds;
+		_rm.detach( block );
+		_ram.free( ds );
+	}
+
+	void *Large_allocator::alloc( const size_t size )
+	{
+		const size_t PAGE = 4096;
+		const size_t ds_size = ( sizeof( Block ) + size + PAGE - 1 ) & ~( PAGE - 1 );
+		Block *block = _from_cache( ds_size );
+
+		if ( nullptr == block )
+		{
+			Genode::Ram_dataspace_capability ds;
+
+			try
+			{
+				ds = _ram.alloc( ds_size );
+			}
+			catch ( ... )
+			{
+				return nullptr;
+			}
+
+			try
+			{
+				block = _rm.attach( ds );
+			}
+			catch ( ... )
+			{
+				_ram.free( ds );
+				return nullptr;
+			}
+
+			block->ds = ds;
+			block->size = ds_size;
+		}
+
+		block->next = nullptr;
+		return block + 1;
+	}
+
+	void Large_allocator::free( void *p )
+	{
+		Block *block = static_cast<Block *>( p ) - 1;
+
+		{
+			Genode::Lock_guard<Genode::Lock> guard( _lock );
+
+			if ( _cached < CACHE_ENTRIES && _cached_bytes + block->size <= CACHE_BYTES )
+			{
+				block->next = _cache;
+				_cache = block;
+				++_cached;
+				_cached_bytes += block->size;
+				return;
+			}
+		}
+
+		_release( block );
+	}
+
+	void Large_allocator::flush()
+	{
+		Block *cache = nullptr;
+
+		{
+			Genode::Lock_guard<Genode::Lock> guard( _lock );
+			cache = _cache;
+			_cache = nullptr;
+			_cached = 0;
+			_cached_bytes = 0;
+		}
+
+		while ( nullptr != cache )
+		{
+			Block *next = cache->next;
+			_release( cache );
+			cache = next;
+		}
+	}
+
+	Genode::Ram_dataspace_capability Large_allocator::dataspace( const void *p, size_t &offset )
+	{
+		const Block *block = static_cast<const Block *>( p ) - 1;
+		offset = static_cast<const char *>( p ) - reinterpret_cast<const char *>( block );
+		return block->ds;
+	}
+
+	Slab_allocator::Slab_allocator(): _current( 0 ), _large( nullptr )
+	{
+		_backing[0] = Genode::env()->heap();
+		_backing[1] = nullptr;
+	}
+
+	void Slab_allocator::backing( Genode::Allocator &heap )
+	{
+		Genode::Lock_guard<Genode::Lock> guard( _central_lock );
+		_backing[1] = &heap;
+		_current = 1;
+	}
+
+	void Slab_allocator::large( Large_allocator &large )
+	{
+		Genode::Lock_guard<Genode::Lock> guard( _central_lock );
+		_large = &large;
+	}
+
+	void *Slab_allocator::_alloc_large( size_t size, const unsigned tag )
+	{
+		void *ret = nullptr;
+		unsigned backing = _current;
+
+		if ( size >= Large_allocator::THRESHOLD && nullptr != _large )
+		{
+			backing = DATASPACE;
+			ret = _large->alloc( sizeof( Header ) + size );
+		}
+		else if ( not _backing[backing]->alloc( sizeof( Header ) + size, &ret ) )
+		{
+			return nullptr;
+		}
+
+		if ( nullptr == ret )
+		{
+			return nullptr;
+		}
+
+		Header *header = static_cast<Header *>( ret );
+		header->cls = LARGE;
+		header->backing = backing;
+		header->tag = tag;
+		header->size = size;
+		return header + 1;
+	}
+
+	void Slab_allocator::_free_large( Header *header )
+	{
+#ifdef CSL_ALLOC_STATS
+		Alloc_stats::freed( Alloc_stats::LARGE, header->size, header->tag );
+#endif
+		if ( DATASPACE == header->backing )
+		{
+			_large->free( header );
+			return;
+		}
+
+		_backing[header->backing]->free( header, sizeof( Header ) + header->size );
+	}
+
+	bool Slab_allocator::_carve( const unsigned cls )
+	{
+		const size_t block = sizeof( Header ) + class_size( cls );
+		void *chunk = nullptr;
+
+		if ( not _backing[_current]->alloc( CHUNK_SIZE, &chunk ) || nullptr == chunk )
+		{
+			return false;
+		}
+
+		char *p = static_cast<char *>( chunk );
+
+		for ( size_t i = 0; i + block <= CHUNK_SIZE; i += block )
+		{
+			Header *header = reinterpret_cast<Header *>( p + i );
+			header->cls = cls;
+			_central[cls].push( reinterpret_cast<Free_block *>( header ) );
+		}
+
+		return true;
+	}
+
+	bool Slab_allocator::_refill( Free_list &list, const unsigned cls )
+	{
+		Genode::Lock_guard<Genode::Lock> guard( _central_lock );
+		Free_list &central = _central[cls];
+
+		if ( 0 == central.count && not _carve( cls ) )
+		{
+			return false;
+		}
+
+		for ( unsigned i = 0; i < BATCH && 0 != central.count; ++i )
+		{
+			list.push( central.pop() );
+		}
+
+		return true;
+	}
+
+	void Slab_allocator::_drain( Free_list &list, const unsigned cls )
+	{
+		Genode::Lock_guard<Genode::Lock> guard( _central_lock );
+
+		for ( unsigned i = 0; i < BATCH; ++i )
+		{
+			_central[cls].push( list.pop() );
+		}
+	}
+
+	void *Slab_allocator::alloc( size_t size, const unsigned tag, void *caller )
+	{
+		if ( size > MAX_SLAB_SIZE )
+		{
+			void *ret = _alloc_large( size, tag );
+#ifdef CSL_ALLOC_STATS
+
+			if ( nullptr != ret )
+			{
+				Alloc_stats::allocated( Alloc_stats::LARGE, size, tag, caller );
+			}
+
+#endif
+			return ret;
+		}
+
+		const unsigned cls = class_of( size ? size : 1 );
+		Cache &cache = *_caches[thread_slot( CACHES )];
+		Genode::Lock_guard<Genode::Lock> guard( cache.lock );
+		Free_list &list = cache.lists[cls];
+
+		if ( 0 == list.count && not _refill( list, cls ) )
+		{
+			return nullptr;
+		}
+
+		// The free list link overwrote the header
+		Header *header = reinterpret_cast<Header *>( list.pop() );
+		header->cls = cls;
+		header->tag = tag;
+#ifdef CSL_ALLOC_STATS
+		Alloc_stats::allocated( cls, class_size( cls ), tag, caller );
+#endif
+		return header + 1;
+	}
+
+	void Slab_allocator::_free_slab( Header *header, const unsigned cls )
+	{
+#ifdef CSL_ALLOC_STATS
+		Alloc_stats::freed( cls, class_size( cls ), header->tag );
+#endif
+		Cache &cache = *_caches[thread_slot( CACHES )];
+		Genode::Lock_guard<Genode::Lock> guard( cache.lock );
+		Free_list &list = cache.lists[cls];
+		list.push( reinterpret_cast<Free_block *>( header ) );
+
+		if ( list.count >= 2 * BATCH )
+		{
+			_drain( list, cls );
+		}
+	}
+
+	void Slab_allocator::free( void *p )
+	{
+		if ( nullptr == p )
+		{
+			return;
+		}
+
+		Header *header = static_cast<Header *>( p ) - 1;
+
+		if ( LARGE == header->cls )
+		{
+			_free_large( header );
+			return;
+		}
+
+		_free_slab( header, header->cls );
+	}
+
+	void Slab_allocator::free( void *p, size_t size )
+	{
+		if ( nullptr == p )
+		{
+			return;
+		}
+
+		Header *header = static_cast<Header *>( p ) - 1;
+
+		if ( size > MAX_SLAB_SIZE )
+		{
+			_free_large( header );
+			return;
+		}
+
+		_free_slab( header, class_of( size ? size : 1 ) );
+	}
+
+	bool Slab_allocator::reserve( const size_t size, const size_t n )
+	{
+		if ( size > MAX_SLAB_SIZE )
+		{
+			return true;
+		}
+
+		const unsigned cls = class_of( size ? size : 1 );
+		Genode::Lock_guard<Genode::Lock> guard( _central_lock );
+
+		while ( _central[cls].count < n )
+		{
+			if ( not _carve( cls ) )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	Genode::Ram_dataspace_capability Slab_allocator::dataspace( const void *p,
+	                                                            size_t &offset ) const
+	{
+		const Header *header = static_cast<const Header *>( p ) - 1;
+
+		if ( LARGE != header->cls || DATASPACE != header->backing )
+		{
+			offset = 0;
+			return Genode::Ram_dataspace_capability();
+		}
+
+		const Genode::Ram_dataspace_capability ds = Large_allocator::dataspace( header, offset );
+		offset += sizeof( Header );
+		return ds;
+	}
+
+	Slab_allocator &Slab_allocator::instance()
+	{
+		static Slab_allocator inst;
+		return inst;
+	}
+
+	void init_allocator( Genode::Env &env )
+	{
+		static char storage[sizeof( Genode::Heap )] alignas( Genode::Heap );
+		static char large_storage[sizeof( Large_allocator )] alignas( Large_allocator );
+		static Genode::Heap *heap = nullptr;
+
+		if ( nullptr == heap )
+		{
+			heap = Genode::construct_at<Genode::Heap>( storage, env.ram(), env.rm() );
+			Slab_allocator::instance().backing( *heap );
+			Slab_allocator::instance().large(
+			    *Genode::construct_at<Large_allocator>( large_storage, env ) );
+		}
+	}
+
+	static Genode::Lock &tags_lock()
+	{
+		static Genode::Lock lock;
+		return lock;
+	}
+
+	static const Alloc_tag *tags[Alloc_tag::MAX_TAGS];
+	static unsigned tag_count = 1;
+
+	Alloc_tag::Alloc_tag( const char *name ): _name( name ), _id( 0 )
+	{
+		Genode::Lock_guard<Genode::Lock> guard( tags_lock() );
+
+		if ( tag_count < MAX_TAGS )
+		{
+			_id = tag_count++;
+			tags[_id] = this;
+		}
+	}
+
+	const Alloc_tag *Alloc_tag::by_id( const unsigned id )
+	{
+		Genode::Lock_guard<Genode::Lock> guard( tags_lock() );
+		return id < tag_count ? tags[id] : nullptr;
+	}
+
+#ifdef CSL_ALLOC_STATS
+
+	///
+	/// The counters are plain integers updated with atomic builtins, so
+	/// they are zero before any constructor ran.
+	///
+	static long live;
+	static long peak;
+	static unsigned long class_allocations[Alloc_stats::LARGE + 1];
+	static unsigned long tag_allocs[Alloc_tag::MAX_TAGS];
+	static long tag_live[Alloc_tag::MAX_TAGS];
+	static unsigned long sampled;
+	static unsigned long dropped;
+	static Alloc_stats::Site sites[Alloc_stats::SITES];
+
+	static Genode::Lock &sites_lock()
+	{
+		static Genode::Lock lock;
+		return lock;
+	}
+
+	static void sample( void *caller, const size_t bytes )
+	{
+		Genode::Lock_guard<Genode::Lock> guard( sites_lock() );
+		const unsigned start = ( reinterpret_cast<Genode::addr_t>( caller ) >> 2 ) % Alloc_stats::SITES;
+
+		for ( unsigned i = 0; i < Alloc_stats::SITES; ++i )
+		{
+			Alloc_stats::Site &site = sites[( start + i ) % Alloc_stats::SITES];
+
+			if ( nullptr == site.address )
+			{
+				site.address = caller;
+			}
+
+			if ( site.address == caller )
+			{
+				++site.samples;
+				site.bytes += bytes;
+				return;
+			}
+		}
+
+		++dropped;
+	}
+
+	void Alloc_stats::allocated( const unsigned cls, const size_t bytes, const unsigned tag,
+	                             void *caller )
+	{
+		const long now = __atomic_add_fetch( &live, long( bytes ), __ATOMIC_RELAXED );
+		long high = __atomic_load_n( &peak, __ATOMIC_RELAXED );
+
+		while ( now > high && not __atomic_compare_exchange_n( &peak, &high, now, true,
+		        __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) {}
+
+		__atomic_fetch_add( &class_allocations[cls], 1UL, __ATOMIC_RELAXED );
+		__atomic_fetch_add( &tag_allocs[tag], 1UL, __ATOMIC_RELAXED );
+		__atomic_fetch_add( &tag_live[tag], long( bytes ), __ATOMIC_RELAXED );
+
+		if ( nullptr != caller &&
+		     0 == __atomic_fetch_add( &sampled, 1UL, __ATOMIC_RELAXED ) % SAMPLE_PERIOD )
+		{
+			sample( caller, bytes );
+		}
+	}
+
+	void Alloc_stats::freed( unsigned, const size_t bytes, const unsigned tag )
+	{
+		__atomic_fetch_sub( &live, long( bytes ), __ATOMIC_RELAXED );
+		__atomic_fetch_sub( &tag_live[tag], long( bytes ), __ATOMIC_RELAXED );
+	}
+
+	bool Alloc_stats::enabled()
+	{
+		return true;
+	}
+
+	long Alloc_stats::live_bytes()
+	{
+		return __atomic_load_n( &live, __ATOMIC_RELAXED );
+	}
+
+	long Alloc_stats::peak_bytes()
+	{
+		return __atomic_load_n( &peak, __ATOMIC_RELAXED );
+	}
+
+	void Alloc_stats::reset_peak()
+	{
+		__atomic_store_n( &peak, live_bytes(), __ATOMIC_RELAXED );
+	}
+
+	unsigned long Alloc_stats::allocations( const unsigned cls )
+	{
+		return cls <= LARGE ? __atomic_load_n( &class_allocations[cls], __ATOMIC_RELAXED ) : 0;
+	}
+
+	unsigned long Alloc_stats::tag_allocations( const unsigned id )
+	{
+		return id < Alloc_tag::MAX_TAGS ? __atomic_load_n( &tag_allocs[id], __ATOMIC_RELAXED ) : 0;
+	}
+
+	long Alloc_stats::tag_live_bytes( const unsigned id )
+	{
+		return id < Alloc_tag::MAX_TAGS ? __atomic_load_n( &tag_live[id], __ATOMIC_RELAXED ) : 0;
+	}
+
+	unsigned long Alloc_stats::dropped_samples()
+	{
+		Genode::Lock_guard<Genode::Lock> guard( sites_lock() );
+		return dropped;
+	}
+
+	unsigned Alloc_stats::_copy_sites( Site *copy )
+	{
+		Genode::Lock_guard<Genode::Lock> guard( sites_lock() );
+		unsigned n = 0;
+
+		for ( unsigned i = 0; i < SITES; ++i )
+		{
+			if ( nullptr != sites[i].address )
+			{
+				copy[n++] = sites[i];
+			}
+		}
+
+		return n;
+	}
+
+#else
+
+	void Alloc_stats::allocated( unsigned, size_t, unsigned, void * )
+	{
+	}
+
+	void Alloc_stats::freed( unsigned, size_t, unsigned )
+	{
+	}
+
+	bool Alloc_stats::enabled()
+	{
+		return false;
+	}
+
+	long Alloc_stats::live_bytes()
+	{
+		return 0;
+	}
+
+	long Alloc_stats::peak_bytes()
+	{
+		return 0;
+	}
+
+	void Alloc_stats::reset_peak()
+	{
+	}
+
+	unsigned long Alloc_stats::allocations( unsigned )
+	{
+		return 0;
+	}
+
+	unsigned long Alloc_stats::tag_allocations( unsigned )
+	{
+		return 0;
+	}
+
+	long Alloc_stats::tag_live_bytes( unsigned )
+	{
+		return 0;
+	}
+
+	unsigned long Alloc_stats::dropped_samples()
+	{
+		return 0;
+	}
+
+	unsigned Alloc_stats::_copy_sites( Site * )
+	{
+		return 0;
+	}
+
+#endif
+} // namespace Csl
+
+static void *csl_alloc( size_t n, const unsigned tag, void *caller ) throw( bad_alloc )
 {
-	void *ret;
-	Genode::env()->heap()->alloc( n, &ret );
+	void *ret = Csl::Slab_allocator::instance().alloc( n, tag, caller );
 
 	if ( nullptr == ret )
 	{
@@ -44,12 +632,52 @@ void *operator new[]( size_t n ) throw( bad_alloc )
 	return ret;
 }
 
+void *operator new( size_t n ) throw( bad_alloc )
+{
+	return csl_alloc( n, 0, __builtin_return_address( 0 ) );
+}
+
+void *operator new[]( size_t n ) throw( bad_alloc )
+{
+	return csl_alloc( n, 0, __builtin_return_address( 0 ) );
+}
+
+void *operator new( size_t n, const Csl::Alloc_tag &tag )
+{
+	return csl_alloc( n, tag.id(), __builtin_return_address( 0 ) );
+}
+
+void *operator new[]( size_t n, const Csl::Alloc_tag &tag )
+{
+	return csl_alloc( n, tag.id(), __builtin_return_address( 0 ) );
+}
+
+void operator delete( void *p, const Csl::Alloc_tag & )
+{
+	Csl::Slab_allocator::instance().free( p );
+}
+
+void operator delete[]( void *p, const Csl::Alloc_tag & )
+{
+	Csl::Slab_allocator::instance().free( p );
+}
+
 void operator delete( void *p ) throw()
 {
-	Genode::env()->heap()->free( p, 0 );
+	Csl::Slab_allocator::instance().free( p );
 }
+
 void operator delete[]( void *p ) throw()
 {
-	Genode::env()->heap()->free( p, 0 );
+	Csl::Slab_allocator::instance().free( p );
 }
 
+void operator delete( void *p, size_t n ) throw()
+{
+	Csl::Slab_allocator::instance().free( p, n );
+}
+
+void operator delete[]( void *p, size_t n ) throw()
+{
+	Csl::Slab_allocator::instance().free( p, n );
+}
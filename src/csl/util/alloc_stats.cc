@@ -0,0 +1,152 @@
+///
+/// \file       csl/util/alloc_stats.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Reporting of the allocation statistics
+///
+#include <csl/util/alloc.h>
+
+#include <base/log.h>
+#include <base/signal.h>
+#include <os/reporter.h>
+#include <timer_session/connection.h>
+
+namespace Csl
+{
+	void Alloc_stats::log()
+	{
+		if ( not enabled() )
+		{
+			Genode::log( "alloc stats: disabled, build with CSL_ALLOC_STATS" );
+			return;
+		}
+
+		Genode::log( "alloc stats: live ", live_bytes(), " bytes, peak ", peak_bytes(), " bytes" );
+
+		for ( unsigned c = 0; c < LARGE; ++c )
+		{
+			if ( 0 != allocations( c ) )
+			{
+				Genode::log( "  class ", Slab_allocator::class_size( c ), ": ",
+				             allocations( c ), " allocations" );
+			}
+		}
+
+		Genode::log( "  large: ", allocations( LARGE ), " allocations" );
+
+		for ( unsigned t = 0; t < Alloc_tag::MAX_TAGS; ++t )
+		{
+			const Alloc_tag *tag = Alloc_tag::by_id( t );
+
+			if ( 0 != tag_allocations( t ) )
+			{
+				Genode::log( "  tag ", tag ? tag->name() : "untagged", ": ",
+				             tag_allocations( t ), " allocations, ",
+				             tag_live_bytes( t ), " bytes live" );
+			}
+		}
+
+		for_each_site( [&]( const Site & site )
+		{
+			Genode::log( "  site ", site.address, ": ", site.samples, " samples, ",
+			             site.bytes, " bytes" );
+		} );
+	}
+
+	struct Alloc_stats_reporter::Impl
+	{
+		static const Genode::size_t REPORT_SIZE = 64 * 1024;
+
+		Genode::Reporter reporter;
+		Timer::Connection timer;
+		Genode::Signal_handler<Impl> handler;
+
+		Impl( Genode::Env &env, unsigned long period_ms ):
+			reporter( env, "alloc_stats", "alloc_stats", REPORT_SIZE ),
+			timer( env ),
+			handler( env.ep(), *this, &Impl::report )
+		{
+			reporter.enabled( true );
+			timer.sigh( handler );
+			timer.trigger_periodic( period_ms * 1000 );
+		}
+
+		void report()
+		{
+			Genode::Reporter::Xml_generator xml( reporter, [&]()
+			{
+				xml.attribute( "live", Alloc_stats::live_bytes() );
+				xml.attribute( "peak", Alloc_stats::peak_bytes() );
+
+				for ( unsigned c = 0; c <= Alloc_stats::LARGE; ++c )
+				{
+					if ( 0 == Alloc_stats::allocations( c ) )
+					{
+						continue;
+					}
+
+					xml.node( "class", [&]()
+					{
+						if ( c < Alloc_stats::LARGE )
+						{
+							xml.attribute( "size", Slab_allocator::class_size( c ) );
+						}
+						else
+						{
+							xml.attribute( "size", "large" );
+						}
+
+						xml.attribute( "allocations", Alloc_stats::allocations( c ) );
+					} );
+				}
+
+				for ( unsigned t = 0; t < Alloc_tag::MAX_TAGS; ++t )
+				{
+					if ( 0 == Alloc_stats::tag_allocations( t ) )
+					{
+						continue;
+					}
+
+					const Alloc_tag *tag = Alloc_tag::by_id( t );
+
+					xml.node( "tag", [&]()
+					{
+						xml.attribute( "name", tag ? tag->name() : "untagged" );
+						xml.attribute( "allocations", Alloc_stats::tag_allocations( t ) );
+						xml.attribute( "live", Alloc_stats::tag_live_bytes( t ) );
+					} );
+				}
+
+				Alloc_stats::for_each_site( [&]( const Alloc_stats::Site & site )
+				{
+					xml.node( "site", [&]()
+					{
+						xml.attribute( "address", Genode::String<32>( Genode::Hex( Genode::addr_t( site.address ) ) ) );
+						xml.attribute( "samples", site.samples );
+						xml.attribute( "bytes", site.bytes );
+					} );
+				} );
+			} );
+		}
+	};
+
+	Alloc_stats_reporter::Alloc_stats_reporter( Genode::Env &env, unsigned long period_ms ):
+		_impl( new Impl( env, period_ms ) )
+	{}
+
+	Alloc_stats_reporter::~Alloc_stats_reporter()
+	{
+		delete _impl;
+	}
+
+	void Alloc_stats_reporter::report()
+	{
+		_impl->report();
+	}
+} // namespace Csl
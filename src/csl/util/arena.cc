@@ -0,0 +1,119 @@
+///
+/// \file       csl/util/arena.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Bump-pointer allocator for request-scoped work
+///
+#include <csl/util/arena.h>
+
+namespace Csl
+{
+	Arena::Arena( Genode::Env &env, size_t chunk_size ):
+		_ram( env.ram() ),
+		_rm( env.rm() ),
+		_chunk_size( chunk_size ),
+		_chunks( nullptr ),
+		_top( nullptr ),
+		_end( nullptr ),
+		_consumed( 0 )
+	{}
+
+	Arena::~Arena()
+	{
+		while ( nullptr != _chunks )
+		{
+			Chunk *next = _chunks->next;
+			_release( _chunks );
+			_chunks = next;
+		}
+	}
+
+	bool Arena::_grow( const size_t size )
+	{
+		size_t chunk_size = sizeof( Chunk ) + size;
+
+		if ( chunk_size < _chunk_size )
+		{
+			chunk_size = _chunk_size;
+		}
+
+		Genode::Ram_dataspace_capability ds;
+
+		try
+		{
+			ds = _ram.alloc( chunk_size );
+		}
+		catch ( ... )
+		{
+			return false;
+		}
+
+		Chunk *chunk = nullptr;
+
+		try
+		{
+			chunk = _rm.attach( ds );
+		}
+		catch ( ... )
+		{
+			_ram.free( ds );
+			return false;
+		}
+
+		chunk->ds = ds;
+		chunk->size = chunk_size;
+		chunk->next = _chunks;
+		_chunks = chunk;
+		_top = reinterpret_cast<char *>( chunk + 1 );
+		_end = reinterpret_cast<char *>( chunk ) + chunk_size;
+		return true;
+	}
+
+	void Arena::_release( Chunk *chunk )
+	{
+		Genode::Ram_dataspace_capability ds = chunk->ds;
+		_rm.detach( chunk );
+		_ram.free( ds );
+	}
+
+	bool Arena::alloc( size_t size, void **out_addr )
+	{
+		size = ( size + ALIGN - 1 ) & ~( ALIGN - 1 );
+
+		if ( size_t( _end - _top ) < size && not _grow( size ) )
+		{
+			return false;
+		}
+
+		*out_addr = _top;
+		_top += size;
+		_consumed += size;
+		return true;
+	}
+
+	void Arena::reset()
+	{
+		if ( nullptr == _chunks )
+		{
+			return;
+		}
+
+		// Keep the oldest chunk
+		while ( nullptr != _chunks->next )
+		{
+			Chunk *next = _chunks->next;
+			_release( _chunks );
+			_chunks = next;
+		}
+
+		_top = reinterpret_cast<char *>( _chunks + 1 );
+		_end = reinterpret_cast<char *>( _chunks ) + _chunks->size;
+		_consumed = 0;
+	}
+} // namespace Csl
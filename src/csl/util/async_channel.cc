@@ -0,0 +1,13 @@
+///
+/// \file       csl/util/async_channel.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Request/response channel with multiple requests in flight
+///
+#include <csl/util/async_channel.h>
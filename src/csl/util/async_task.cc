@@ -0,0 +1,87 @@
+///
+/// \file       csl/util/async_task.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Stackless tasks, resumed by a scheduler on the entrypoint
+///
+#include <csl/util/async_task.h>
+#include <csl/util/assert.h>
+
+namespace Csl
+{
+	void Async_task::wake()
+	{
+		if ( nullptr == _scheduler )
+		{
+			return;
+		}
+
+		if ( not _woken.exchange( true ) )
+		{
+			_scheduler->_wake( *this );
+		}
+	}
+
+	Task_scheduler::Task_scheduler( Reactor &reactor ):
+		_reactor( reactor ),
+		_notifier( reactor.watch( _woken, [this]( Async_task * task ) { _run( *task ); } ) ),
+		_active( 0 )
+	{}
+
+	void Task_scheduler::_wake( Async_task &task )
+	{
+		_woken.enqueue( &task );
+		_notifier.notify();
+	}
+
+	void Task_scheduler::_finish( Async_task &task )
+	{
+		task._scheduler = nullptr;
+		--_active;
+		task.finished();
+	}
+
+	void Task_scheduler::_run( Async_task &task )
+	{
+		if ( task._done )
+		{
+			// Woken while it finished, it was left for this wakeup
+			_finish( task );
+			return;
+		}
+
+		// Wakeups from now on resume the task again
+		task._woken.store( false );
+
+		if ( Async_task::DONE != task.run() )
+		{
+			return;
+		}
+
+		task._done = true;
+
+		// Ignore wakeups from now on. When one is queued already, finish
+		// when it comes by, as the task may be deleted by finished().
+		if ( not task._woken.exchange( true ) )
+		{
+			_finish( task );
+		}
+	}
+
+	void Task_scheduler::spawn( Async_task &task )
+	{
+		cslassert( nullptr == task._scheduler );
+		task._scheduler = this;
+		task._done = false;
+		task._resume_point = 0;
+		task._woken.store( false );
+		++_active;
+		task.wake();
+	}
+} // namespace Csl
@@ -0,0 +1,113 @@
+///
+/// \file       csl/util/buffer.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Reference counted byte buffers
+///
+#include <util/construct_at.h>
+
+#include <csl/util/buffer.h>
+#include <csl/util/fthrow.h>
+
+namespace Csl
+{
+	Buffer::Storage *Buffer::_allocate( const size_t capacity )
+	{
+		void *p = ::operator new( sizeof( Storage ) + capacity );
+		return Genode::construct_at<Storage>( p, capacity );
+	}
+
+	Buffer Buffer::allocate( const size_t size, const size_t headroom, const size_t tailroom )
+	{
+		Storage *storage = _allocate( headroom + size + tailroom );
+		return Buffer( storage, storage->data() + headroom, size );
+	}
+
+	Buffer Buffer::copy( const Data_descriptor &dd, const size_t headroom, const size_t tailroom )
+	{
+		const size_t size = dd.valid() ? dd.size() : 0;
+		Buffer b = allocate( size, headroom, tailroom );
+
+		if ( 0 != size )
+		{
+			Genode::memcpy( b._data, dd.data(), size );
+		}
+
+		return b;
+	}
+
+	void Buffer::_reallocate( const size_t headroom, const size_t tailroom )
+	{
+		Buffer b = copy( dd(), headroom, tailroom );
+		*this = static_cast<Buffer &&>( b );
+	}
+
+	Buffer Buffer::slice( const size_t offset, const size_t size ) const
+	{
+		if ( offset > _size || size > _size - offset )
+		{
+			fthrow<Out_of_range>( "Slice of %lu bytes at %lu exceeds buffer of %lu bytes",
+			                      size, offset, _size );
+		}
+
+		Buffer b( *this );
+		b._data += offset;
+		b._size = size;
+		return b;
+	}
+
+	Data_descriptor_mod Buffer::push( const size_t n )
+	{
+		if ( not unique() || headroom() < n )
+		{
+			// room for the next header too
+			_reallocate( n + DEFAULT_HEADROOM, tailroom() );
+		}
+
+		_data -= n;
+		_size += n;
+		return Data_descriptor_mod( _data, n );
+	}
+
+	Data_descriptor Buffer::pull( const size_t n )
+	{
+		if ( n > _size )
+		{
+			fthrow<Out_of_range>( "Can't pull %lu bytes from buffer of %lu bytes", n, _size );
+		}
+
+		const Data_descriptor header( _data, n );
+		_data += n;
+		_size -= n;
+		return header;
+	}
+
+	Data_descriptor_mod Buffer::put( const size_t n )
+	{
+		if ( not unique() || tailroom() < n )
+		{
+			// grow geometrically, so appending piecewise is linear
+			_reallocate( headroom(), n + _size );
+		}
+
+		uint8_t *tail = _data + _size;
+		_size += n;
+		return Data_descriptor_mod( tail, n );
+	}
+
+	void Buffer::trim( const size_t n )
+	{
+		if ( n > _size )
+		{
+			fthrow<Out_of_range>( "Can't trim %lu bytes from buffer of %lu bytes", n, _size );
+		}
+
+		_size -= n;
+	}
+} // namespace Csl
@@ -0,0 +1,56 @@
+///
+/// \file       csl/util/codec.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Cursors to read and write binary wire formats
+///
+#include <csl/util/codec.h>
+#include <csl/util/fthrow.h>
+
+namespace Csl
+{
+	void Reader::_underflow( const size_t size ) const
+	{
+		fthrow<Out_of_range>( "Can't read %lu bytes at offset %lu, %lu bytes left",
+		                      size, position(), left() );
+		throw Out_of_range();   // not reached, fthrow isn't noreturn
+	}
+
+	uint64_t Reader::_get_varint_checked()
+	{
+		uint64_t v = 0;
+
+		for ( unsigned shift = 0; shift < 64; shift += 7 )
+		{
+			const uint8_t b = get_u8();
+
+			// the 10th byte holds only bit 63
+			if ( 63 == shift && b > 1 )
+			{
+				throw Out_of_range( "Varint exceeds 64 bits" );
+			}
+
+			v |= uint64_t( b & 0x7f ) << shift;
+
+			if ( 0 == ( b & 0x80 ) )
+			{
+				return v;
+			}
+		}
+
+		throw Out_of_range( "Varint exceeds 64 bits" );
+	}
+
+	void Writer::_overflow( const size_t size ) const
+	{
+		fthrow<Out_of_range>( "Can't write %lu bytes at offset %lu, %lu bytes left",
+		                      size, position(), left() );
+		throw Out_of_range();   // not reached, fthrow isn't noreturn
+	}
+} // namespace Csl
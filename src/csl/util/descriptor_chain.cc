@@ -0,0 +1,59 @@
+///
+/// \file       csl/util/descriptor_chain.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Scatter-gather lists of Data_descriptors
+///
+#include <csl/util/descriptor_chain.h>
+
+namespace Csl
+{
+	void Internet_checksum::add( const uint8_t *data, size_t size )
+	{
+		if ( 0 == size )
+		{
+			return;
+		}
+
+		// finish the word the previous fragment ended in
+		if ( _odd )
+		{
+			_sum += *data++;
+			--size;
+			_odd = false;
+		}
+
+		uint64_t sum = _sum;
+
+		for ( ; size >= 2; data += 2, size -= 2 )
+		{
+			sum += ( uint32_t( data[0] ) << 8 ) | data[1];
+		}
+
+		if ( 0 != size )
+		{
+			sum += uint32_t( data[0] ) << 8;
+			_odd = true;
+		}
+
+		_sum = sum;
+	}
+
+	uint16_t Internet_checksum::value() const
+	{
+		uint64_t sum = _sum;
+
+		while ( 0 != ( sum >> 16 ) )
+		{
+			sum = ( sum & 0xffff ) + ( sum >> 16 );
+		}
+
+		return uint16_t( ~sum );
+	}
+} // namespace Csl
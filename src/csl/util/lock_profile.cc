@@ -0,0 +1,93 @@
+///
+/// \file       csl/util/lock_profile.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Lock contention profiling
+///
+#include <csl/util/lock_profile.h>
+
+#include <base/signal.h>
+#include <os/reporter.h>
+#include <timer_session/connection.h>
+
+namespace Csl
+{
+	struct Lock_profile_reporter::Impl
+	{
+		static const Genode::size_t REPORT_SIZE = 64 * 1024;
+
+		Genode::Reporter reporter;
+		Timer::Connection timer;
+		Genode::Signal_handler<Impl> handler;
+
+		Impl( Genode::Env &env, unsigned long period_ms ):
+			reporter( env, "lock_profile", "lock_profile", REPORT_SIZE ),
+			timer( env ),
+			handler( env.ep(), *this, &Impl::report )
+		{
+			reporter.enabled( true );
+			timer.sigh( handler );
+			timer.trigger_periodic( period_ms * 1000 );
+		}
+
+		static void histogram( Genode::Xml_generator &xml, const char *type,
+		                       const Lock_profile &p,
+		                       unsigned long ( Lock_profile::*count )( unsigned ) const )
+		{
+			for ( unsigned i = 0; i < Lock_profile::BUCKETS; ++i )
+			{
+				const unsigned long n = ( p.*count )( i );
+
+				if ( 0 == n )
+				{
+					continue;
+				}
+
+				xml.node( type, [&]()
+				{
+					xml.attribute( "bucket", i );
+					xml.attribute( "count", n );
+				} );
+			}
+		}
+
+		void report()
+		{
+			Genode::Reporter::Xml_generator xml( reporter, [&]()
+			{
+				Lock_profile::for_each( [&]( const Lock_profile &p )
+				{
+					xml.node( "lock", [&]()
+					{
+						xml.attribute( "name", p.name() );
+						xml.attribute( "acquisitions", p.acquisitions() );
+						xml.attribute( "contended", p.contended() );
+						histogram( xml, "wait", p, &Lock_profile::wait_histogram );
+						histogram( xml, "hold", p, &Lock_profile::hold_histogram );
+					} );
+				} );
+			} );
+		}
+	};
+
+	Lock_profile_reporter::Lock_profile_reporter( Genode::Env &env,
+	        unsigned long period_ms ):
+		_impl( new Impl( env, period_ms ) )
+	{}
+
+	Lock_profile_reporter::~Lock_profile_reporter()
+	{
+		delete _impl;
+	}
+
+	void Lock_profile_reporter::report()
+	{
+		_impl->report();
+	}
+} // namespace Csl
@@ -0,0 +1,13 @@
+///
+/// \file       csl/util/parallel.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Parallel algorithms on top of the Thread_pool
+///
+#include <csl/util/parallel.h>
@@ -0,0 +1,154 @@
+///
+/// \file       csl/util/reactor.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Event loop for signals, timeouts and queues on one entrypoint
+///
+#include <csl/util/reactor.h>
+
+namespace Csl
+{
+	void Reactor::Timeout::once( unsigned long ms )
+	{
+		_reactor._disarm( *this );
+		_period_ms = 0;
+		_deadline_ms = _reactor.now_ms() + ms;
+		_reactor._arm( *this );
+	}
+
+	void Reactor::Timeout::periodic( unsigned long ms )
+	{
+		_reactor._disarm( *this );
+		_period_ms = ms ? ms : 1;
+		_deadline_ms = _reactor.now_ms() + _period_ms;
+		_reactor._arm( *this );
+	}
+
+	void Reactor::Timeout::cancel()
+	{
+		_reactor._disarm( *this );
+	}
+
+	Reactor::Reactor( Genode::Env &env ):
+		_ep( env.ep() ),
+		_timer( env ),
+		_sources( nullptr ),
+		_timer_source( env.ep(), *this ),
+		_timeouts( nullptr )
+	{
+		_timer.sigh( _timer_source.cap() );
+	}
+
+	Reactor::~Reactor()
+	{
+		while ( nullptr != _sources )
+		{
+			Source *next = _sources->_next;
+			delete _sources;
+			_sources = next;
+		}
+	}
+
+	void Reactor::remove( Genode::Signal_context_capability cap )
+	{
+		for ( Source **s = &_sources; nullptr != *s; s = &( *s )->_next )
+		{
+			if ( ( *s )->cap() == cap )
+			{
+				Source *source = *s;
+				*s = source->_next;
+				delete source;
+				return;
+			}
+		}
+	}
+
+	void Reactor::_arm( Timeout &timeout )
+	{
+		Timeout **t = &_timeouts;
+
+		while ( nullptr != *t && ( *t )->_deadline_ms <= timeout._deadline_ms )
+		{
+			t = &( *t )->_next;
+		}
+
+		timeout._next = *t;
+		*t = &timeout;
+		timeout._armed = true;
+
+		if ( _timeouts == &timeout )
+		{
+			_program_timer();
+		}
+	}
+
+	void Reactor::_disarm( Timeout &timeout )
+	{
+		if ( not timeout._armed )
+		{
+			return;
+		}
+
+		for ( Timeout **t = &_timeouts; nullptr != *t; t = &( *t )->_next )
+		{
+			if ( *t == &timeout )
+			{
+				*t = timeout._next;
+				break;
+			}
+		}
+
+		// An early timer signal is harmless, don't reprogram
+		timeout._next = nullptr;
+		timeout._armed = false;
+	}
+
+	void Reactor::_program_timer()
+	{
+		if ( nullptr == _timeouts )
+		{
+			return;
+		}
+
+		const unsigned long now = now_ms();
+		const unsigned long deadline = _timeouts->_deadline_ms;
+		const unsigned long ms = deadline > now ? deadline - now : 0;
+		_timer.trigger_once( ms ? ms * 1000 : 1 );
+	}
+
+	void Reactor::_expire()
+	{
+		const unsigned long now = now_ms();
+
+		// Handle all timeouts that expired, one by one: a handler may
+		// cancel or destroy other timeouts.
+		while ( nullptr != _timeouts && _timeouts->_deadline_ms <= now )
+		{
+			Timeout &t = *_timeouts;
+			_disarm( t );
+
+			if ( t._period_ms )
+			{
+				t._deadline_ms += t._period_ms;
+
+				if ( t._deadline_ms <= now )
+				{
+					// We fell behind, skip the missed periods
+					t._deadline_ms = now + t._period_ms;
+				}
+
+				_arm( t );
+			}
+
+			t._handler.handle();
+		}
+
+		_program_timer();
+	}
+} // namespace Csl
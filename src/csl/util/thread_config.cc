@@ -0,0 +1,126 @@
+///
+/// \file       csl/util/thread_config.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Thread affinity, priority and stack size from the config
+///
+#include <csl/util/thread_config.h>
+#include <csl/util/xml_util.h>
+
+#include <base/log.h>
+#include <util/string.h>
+
+namespace Csl
+{
+	void Thread_factory::_parse( const Genode::Xml_node &thread )
+	{
+		Entry entry;
+		entry.name = get_attribute_val( thread, "name" );
+
+		if ( thread.has_attribute( "cpu" ) )
+		{
+			const unsigned cpu = thread.attribute_value( "cpu", 0U );
+			const Genode::Affinity::Space space = _env.cpu().affinity_space();
+
+			if ( cpu >= space.total() )
+			{
+				Genode::warning( "Thread ", entry.name.c_str(), ": no cpu ", cpu,
+				                 " in an affinity space of ", space.total() );
+			}
+			else
+			{
+				entry.settings.location = space.location_of_index( cpu );
+			}
+		}
+
+		if ( thread.has_attribute( "prio" ) )
+		{
+			entry.settings.priority = thread.attribute_value( "prio", 0L );
+		}
+
+		if ( thread.has_attribute( "stack" ) )
+		{
+			entry.settings.stack_size = thread.attribute_value( "stack",
+			                            Genode::Number_of_bytes( DEFAULT_STACK_SIZE ) );
+		}
+
+		_entries.push_back( entry );
+	}
+
+	Thread_factory::Thread_factory( Genode::Env &env, const Genode::Xml_node &config ):
+		_env( env ), _cpus( nullptr )
+	{
+		try
+		{
+			Genode::Xml_node threads = Xml_path( "csl/threads" ).get_node( config );
+
+			threads.for_each_sub_node( "thread", [&]( Genode::Xml_node thread )
+			{
+				try
+				{
+					_parse( thread );
+				}
+				catch ( ... )
+				{
+					Genode::error( "Error in your thread configuration" );
+				}
+			} );
+		}
+		catch ( ... )
+		{
+			// No thread configuration available
+		}
+	}
+
+	Thread_factory::~Thread_factory()
+	{
+		while ( nullptr != _cpus )
+		{
+			Cpu *next = _cpus->next;
+			delete _cpus;
+			_cpus = next;
+		}
+	}
+
+	Thread_factory::Settings Thread_factory::settings( const char *name ) const
+	{
+		for ( auto i = _entries.begin(); i != _entries.end(); ++i )
+		{
+			if ( i->name == string( name ) )
+			{
+				return i->settings;
+			}
+		}
+
+		return Settings();
+	}
+
+	Genode::Cpu_session &Thread_factory::cpu( const char *name )
+	{
+		const long priority = settings( name ).priority;
+
+		if ( INHERIT_PRIORITY == priority )
+		{
+			return _env.cpu();
+		}
+
+		Genode::Lock::Guard guard( _cpus_lock );
+
+		for ( Cpu *c = _cpus; nullptr != c; c = c->next )
+		{
+			if ( c->priority == priority )
+			{
+				return c->connection;
+			}
+		}
+
+		_cpus = new Cpu( _env, priority, _cpus );
+		return _cpus->connection;
+	}
+} // namespace Csl
@@ -0,0 +1,263 @@
+///
+/// \file       csl/util/thread_pool.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      Work-stealing thread pool
+///
+#include <csl/util/thread_pool.h>
+#include <csl/util/string.h>
+#include <csl/util/exception.h>
+#include <csl/util/logger.h>
+
+namespace Csl
+{
+	Thread_pool::Worker::Worker( Genode::Env &env, Thread_pool &pool, unsigned index,
+	                             const char *name, Genode::Affinity::Location location ):
+		Genode::Thread( env, name, DEFAULT_STACK_SIZE, location, Weight(), env.cpu() ),
+		_pool( pool ), index( index )
+	{}
+
+	void Thread_pool::Worker::entry()
+	{
+		_pool._run( *this );
+	}
+
+	static Genode::Affinity::Location _worker_location( Genode::Env &env,
+	        Genode::Affinity::Location location, unsigned i )
+	{
+		if ( not location.valid() )
+		{
+			return env.cpu().affinity_space().location_of_index( i );
+		}
+
+		return Genode::Affinity::Location( location.xpos() + i % location.width(),
+		                                   location.ypos() + ( i / location.width() ) % location.height(),
+		                                   1, 1 );
+	}
+
+	Thread_pool::Thread_pool( Genode::Env &env, unsigned workers,
+	                          Genode::Affinity::Location location, const char *name ):
+		_env( env ),
+		_count( workers ? workers : env.cpu().affinity_space().total() ),
+		_workers( new Worker *[_count] ),
+		_pending( 0L ),
+		_stop( false )
+	{
+		for ( unsigned i = 0; i < _count; ++i )
+		{
+			const string worker_name = sprintf( "%s.%u", name, i );
+			_workers[i] = new Worker( env, *this, i, worker_name.c_str(),
+			                          _worker_location( env, location, i ) );
+		}
+
+		for ( unsigned i = 0; i < _count; ++i )
+		{
+			_workers[i]->start();
+		}
+	}
+
+	Thread_pool::~Thread_pool()
+	{
+		_stop = true;
+		_workers_parked.wake_all();
+
+		// Workers steal from each other, join all before deleting any
+		for ( unsigned i = 0; i < _count; ++i )
+		{
+			_workers[i]->join();
+		}
+
+		// Discard the tasks that were never started
+		for ( unsigned i = 0; i < _count; ++i )
+		{
+			for ( Task *task; nullptr != ( task = _workers[i]->deque.pop() ); )
+			{
+				task->discard();
+			}
+
+			delete _workers[i];
+		}
+
+		delete[] _workers;
+
+		for ( Task *task = nullptr; _shared.try_dequeue( task ); )
+		{
+			task->discard();
+		}
+	}
+
+	Thread_pool::Worker *Thread_pool::_current_worker() const
+	{
+		Genode::Thread *myself = Genode::Thread::myself();
+
+		for ( unsigned i = 0; i < _count; ++i )
+		{
+			if ( _workers[i] == myself )
+			{
+				return _workers[i];
+			}
+		}
+
+		return nullptr;
+	}
+
+	Task *Thread_pool::_find_work( Worker *self )
+	{
+		Task *task = nullptr;
+
+		if ( nullptr != self && nullptr != ( task = self->deque.pop() ) )
+		{
+			return task;
+		}
+
+		if ( _shared.try_dequeue( task ) )
+		{
+			return task;
+		}
+
+		// Steal, starting with the neighbour so thieves spread out
+		const unsigned first = self ? self->index + 1 : 0;
+
+		for ( unsigned i = 0; i < _count; ++i )
+		{
+			Worker *victim = _workers[( first + i ) % _count];
+
+			if ( victim != self && nullptr != ( task = victim->deque.steal() ) )
+			{
+				return task;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool Thread_pool::_has_work() const
+	{
+		if ( _shared.size() > 0 )
+		{
+			return true;
+		}
+
+		for ( unsigned i = 0; i < _count; ++i )
+		{
+			if ( _workers[i]->deque.size() > 0 )
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void Thread_pool::_execute( Task *task )
+	{
+		// Nobody waits for the result of a task, an escaping exception
+		// would kill the worker or hit an unrelated caller of help()
+		try
+		{
+			task->execute();
+		}
+		catch ( Exception &e )
+		{
+			ELOG( "Task failed: %s", e.what() );
+		}
+		catch ( ... )
+		{
+			ELOG( "Task failed with an unknown exception" );
+		}
+
+		if ( 1 == _pending.fetch_sub( 1 ) )
+		{
+			_idle_parked.wake_all();
+		}
+	}
+
+	void Thread_pool::_run( Worker &self )
+	{
+		while ( not _stop.load( Memory_order::acquire ) )
+		{
+			Task *task = nullptr;
+
+			for ( unsigned spin = 0; spin < SPIN_ROUNDS && nullptr == task; ++spin )
+			{
+				if ( nullptr == ( task = _find_work( &self ) ) )
+				{
+					cpu_relax();
+				}
+			}
+
+			if ( nullptr != task )
+			{
+				_execute( task );
+				continue;
+			}
+
+			_workers_parked.park_unless( [&]()
+			{
+				return _has_work() || _stop.load();
+			} );
+		}
+	}
+
+	void Thread_pool::submit( Task &task )
+	{
+		_pending.fetch_add( 1 );
+		Worker *self = _current_worker();
+
+		if ( nullptr == self || not self->deque.push( &task ) )
+		{
+			_shared.enqueue( &task );
+		}
+
+		_workers_parked.wake_one();
+	}
+
+	void Thread_pool::defer( Task &task )
+	{
+		_pending.fetch_add( 1 );
+		_shared.enqueue( &task );
+		_workers_parked.wake_one();
+	}
+
+	bool Thread_pool::help()
+	{
+		Task *task = _find_work( _current_worker() );
+
+		if ( nullptr == task )
+		{
+			return false;
+		}
+
+		_execute( task );
+		return true;
+	}
+
+	void Thread_pool::wait_idle()
+	{
+		const bool worker = nullptr != _current_worker();
+
+		while ( 0 != _pending.load() )
+		{
+			if ( worker )
+			{
+				if ( not help() )
+				{
+					cpu_relax();
+				}
+
+				continue;
+			}
+
+			_idle_parked.park_unless( [&]()
+			{
+				return 0 == _pending.load();
+			} );
+		}
+	}
+} // namespace Csl
@@ -0,0 +1,176 @@
+///
+/// \file       test/codec/main.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      tests for util/codec.h and util/fields.h
+///
+
+// Genode includes
+#include <base/component.h>
+
+// CSL includes
+#include <csl/util/codec.h>
+#include <csl/util/fields.h>
+#include <csl/util/logger.h>
+
+namespace Codec_test
+{
+	struct Header
+	{
+		Csl::uint32_t spi;
+		Csl::uint16_t length;
+		Csl::uint8_t iv[4];
+
+		CSL_FIELDS( CSL_FIELD( Header, spi ),
+		            CSL_PAD( 2 ),
+		            CSL_FIELD_LE( Header, length ),
+		            CSL_FIELD( Header, iv ) );
+	};
+
+	static_assert( Header::Fields::SIZE == 12, "Header is 12 bytes on the wire" );
+
+	class Main
+	{
+		public:
+			Main( Genode::Env & )
+			{
+				Csl::uint8_t buf[64];
+
+				// Test 1: fixed fields round trip in both byte orders
+				{
+					Csl::Writer w( Csl::Data_descriptor_mod( buf, sizeof( buf ) ) );
+					Csl::Unchecked_writer f = w.fixed( 15 );
+					f.put_u8( 0x01 );
+					f.put_u16be( 0x0203 );
+					f.put_u32le( 0x07060504 );
+					f.put_u64be( 0x08090a0b0c0d0e0fULL );
+
+					bool ok = true;
+
+					for ( unsigned i = 0; i < 15; ++i )
+					{
+						ok = ok && buf[i] == i + 1;
+					}
+
+					Csl::Reader r( w.written() );
+					Csl::Unchecked_reader u = r.fixed( 15 );
+					ok = ok && u.get_u8() == 0x01 && u.get_u16be() == 0x0203 &&
+					     u.get_u32le() == 0x07060504 && u.get_u64be() == 0x08090a0b0c0d0e0fULL &&
+					     r.at_end();
+
+					if ( ok )
+					{ ILOG( "Test 1 succeeded" ); }
+					else
+					{ ELOG( "Test 1: fields don't round trip" ); }
+				}
+
+				// Test 2: varints, also where the checked path is taken
+				{
+					Csl::Writer w( Csl::Data_descriptor_mod( buf, 24 ) );
+					w.put_varint( 300 );
+					w.put_svarint( -3 );
+					w.put_varint( ~0ULL );
+					w.put_varint( 1ULL << 40 );
+
+					Csl::Reader r( w.written() );
+
+					if ( buf[0] == 0xac && buf[1] == 0x02 &&
+					     r.get_varint() == 300 && r.get_svarint() == -3 &&
+					     r.get_varint() == ~0ULL && r.get_varint() == 1ULL << 40 && r.at_end() )
+					{ ILOG( "Test 2 succeeded" ); }
+					else
+					{ ELOG( "Test 2: varints don't round trip" ); }
+				}
+
+				// Test 3: reading past the end throws
+				try
+				{
+					Csl::Reader r( Csl::Data_descriptor( buf, 3 ) );
+					r.get_u16be();
+					r.get_u16be();
+					ELOG( "Test 3: read past the end" );
+				}
+				catch ( Csl::Out_of_range &e )
+				{
+					ILOG( "Test 3 succeeded: %s", e.what() );
+				}
+
+				// Test 4: writing past the end throws, and writes nothing
+				try
+				{
+					Csl::Writer w( Csl::Data_descriptor_mod( buf, 5 ) );
+					w.put_u32be( 1 );
+					w.put_varint( 1000 );
+					ELOG( "Test 4: wrote past the end" );
+				}
+				catch ( Csl::Out_of_range &e )
+				{
+					ILOG( "Test 4 succeeded: %s", e.what() );
+				}
+
+				// Test 5: struct described with CSL_FIELDS
+				{
+					const Header h { 0x01020304, 0x0605, { 7, 8, 9, 10 } };
+					Header g { 0, 0, { 0 } };
+					Csl::Data_descriptor_mod rest = Csl::Data_descriptor_mod( buf, 16 ) << h;
+					Csl::Data_descriptor left = Csl::Data_descriptor( buf, 16 ) >> g;
+
+					if ( rest.size() == 4 && left.size() == 4 &&
+					     buf[0] == 1 && buf[4] == 0 && buf[6] == 5 && buf[11] == 10 &&
+					     g.spi == h.spi && g.length == h.length && g.iv[3] == 10 )
+					{ ILOG( "Test 5 succeeded" ); }
+					else
+					{ ELOG( "Test 5: fields don't round trip" ); }
+				}
+
+				// Test 6: a 10th varint byte beyond bit 63 throws, at the
+				// end of the data and followed by more data
+				{
+					Csl::uint8_t over[12];
+					Genode::memset( over, 0xff, 9 );
+					over[9] = 0x7f;
+					over[10] = 0;
+					over[11] = 0;
+					unsigned thrown = 0;
+
+					for ( Csl::size_t size = 10; size <= 12; size += 2 )
+					{
+						try
+						{
+							Csl::Reader( Csl::Data_descriptor( over, size ) ).get_varint();
+						}
+						catch ( Csl::Out_of_range & )
+						{
+							++thrown;
+						}
+					}
+
+					over[9] = 0x01;
+					Csl::Reader max( Csl::Data_descriptor( over, 10 ) );
+
+					if ( 2 == thrown && ~0ULL == max.get_varint() )
+					{ ILOG( "Test 6 succeeded" ); }
+					else
+					{ ELOG( "Test 6: overlong varint accepted" ); }
+				}
+
+				ILOG( "codec test completed." );
+			}
+	};
+}
+
+Genode::size_t Component::stack_size()
+{
+	return 64*1024;
+}
+
+void Component::construct( Genode::Env &env )
+{
+	static Codec_test::Main main( env );
+}
@@ -0,0 +1,3 @@
+TARGET	= test_codec
+LIBS	= libcsl base
+SRC_CC	= main.cc
@@ -0,0 +1,169 @@
+///
+/// \file       test/rcu/main.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      tests for util/rcu.h
+///
+
+// Genode includes
+#include <base/component.h>
+
+// CSL includes
+#include <csl/util/rcu.h>
+#include <csl/util/thread_pool.h>
+#include <csl/util/logger.h>
+
+namespace Rcu_test
+{
+	/// Version of the protected data, poisoned when deleted
+	struct Version
+	{
+		static const unsigned long ALIVE = 0x600d600dUL;
+		static const unsigned long DEAD = 0xdeaddeadUL;
+
+		unsigned long magic;
+		long value;
+
+		Version(): magic( ALIVE ), value( 0 ) {}
+
+		Version( const Version &other ): magic( ALIVE ), value( other.value ) {}
+
+		~Version()
+		{
+			__atomic_store_n( &magic, DEAD, __ATOMIC_RELAXED );
+		}
+	};
+
+	class Main
+	{
+		private:
+			Genode::Env &_env;
+			Csl::Thread_pool _pool;
+
+		public:
+			Main( Genode::Env &env ) : _env( env ), _pool( _env, 4 )
+			{
+				// Test 1: two updates interleaved with a reader, neither
+				// may free the version the reader holds
+				{
+					Csl::rcu_object<Version> object;
+					Csl::Atomic_variable<bool> inside( false );
+					Csl::Atomic_variable<bool> release( false );
+					Csl::Atomic_variable<int> updates( 0 );
+					Csl::Atomic_variable<bool> alive( true );
+
+					_pool.submit( [&]()
+					{
+						object.read<bool>( [&]( const Version &v )
+						{
+							inside = true;
+
+							while ( not release.load() )
+							{
+								Csl::cpu_relax();
+							}
+
+							alive = Version::ALIVE == __atomic_load_n( &v.magic, __ATOMIC_RELAXED );
+							return true;
+						} );
+					} );
+
+					while ( not inside.load() )
+					{
+						Csl::cpu_relax();
+					}
+
+					_pool.submit( [&]()
+					{
+						object.update( [&]( Version &v ) { ++v.value; } );
+						++updates;
+						object.update( [&]( Version &v ) { ++v.value; } );
+						++updates;
+					} );
+
+					// the first update must wait for the reader
+					for ( unsigned i = 0; i < 10000000 && 0 == updates.load(); ++i )
+					{
+						Csl::cpu_relax();
+					}
+
+					const int early = updates.load();
+					release = true;
+					_pool.wait_idle();
+
+					if ( 0 == early && alive.load() && 2 == updates.load() )
+					{ ILOG( "Test 1 succeeded" ); }
+					else
+					{ ELOG( "Test 1: %d updates before the reader left, alive %d", early, alive.load() ); }
+				}
+
+				// Test 2: readers against two updaters, readers never see
+				// a deleted version
+				{
+					Csl::rcu_object<Version> object;
+					Csl::Atomic_variable<bool> stop( false );
+					Csl::Atomic_variable<long> dead( 0L );
+					Csl::Atomic_variable<int> updaters( 2 );
+
+					for ( int i = 0; i < 2; ++i )
+					{
+						_pool.submit( [&]()
+						{
+							while ( not stop.load( Csl::Memory_order::relaxed ) )
+							{
+								object.read<bool>( [&]( const Version &v )
+								{
+									if ( Version::ALIVE != __atomic_load_n( &v.magic, __ATOMIC_RELAXED ) )
+									{
+										++dead;
+									}
+
+									return true;
+								} );
+							}
+						} );
+
+						_pool.submit( [&]()
+						{
+							for ( int j = 0; j < 2000; ++j )
+							{
+								object.update( [&]( Version &v ) { ++v.value; } );
+							}
+
+							if ( 0 == --updaters )
+							{
+								stop = true;
+							}
+						} );
+					}
+
+					_pool.wait_idle();
+
+					const long value = object.read<long>( []( const Version &v ) { return v.value; } );
+
+					if ( 0 == dead.load() && 4000 == value )
+					{ ILOG( "Test 2 succeeded" ); }
+					else
+					{ ELOG( "Test 2: %ld reads of deleted versions, value %ld", dead.load(), value ); }
+				}
+
+				ILOG( "rcu test completed." );
+			}
+	};
+}
+
+Genode::size_t Component::stack_size()
+{
+	return 64*1024;
+}
+
+void Component::construct( Genode::Env &env )
+{
+	static Rcu_test::Main main( env );
+}
@@ -0,0 +1,3 @@
+TARGET	= test_rcu
+LIBS	= libcsl base
+SRC_CC	= main.cc
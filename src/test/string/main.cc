@@ -0,0 +1,76 @@
+///
+/// \file       test/string/main.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      tests for util/string.h on other allocators
+///
+
+// Genode includes
+#include <base/component.h>
+#include <base/heap.h>
+
+// CSL includes
+#include <csl/util/string.h>
+#include <csl/util/arena.h>
+#include <csl/crypto/secure_pool.h>
+#include <csl/util/logger.h>
+
+namespace String_test
+{
+	class Main
+	{
+		private:
+			Genode::Env &_env;
+			Genode::Heap _heap;
+			Csl::Arena _arena;
+
+		public:
+			Main( Genode::Env &env ) : _env( env ), _heap( env.ram(), env.rm() ), _arena( env )
+			{
+				Csl::init_secure_pool( env );
+
+				// Test 1: empty strings on an allocator
+				{
+					Csl::string on_heap( "", _heap );
+					Csl::string on_arena( "", _arena );
+					on_arena += "abc";
+
+					if ( on_heap.empty() && 0 == on_heap.c_str()[0] && on_arena == "abc" )
+					{ ILOG( "Test 1 succeeded" ); }
+					else
+					{ ELOG( "Test 1: empty strings on an allocator are broken" ); }
+				}
+
+				// Test 2: empty and non-empty secure strings
+				{
+					Csl::Secure_string empty( "" );
+					Csl::Secure_string password( "secret" );
+					Csl::Secure_string copy( empty );
+					copy = password;
+
+					if ( empty.empty() && copy == "secret" )
+					{ ILOG( "Test 2 succeeded" ); }
+					else
+					{ ELOG( "Test 2: secure strings are broken" ); }
+				}
+
+				ILOG( "string test completed." );
+			}
+	};
+}
+
+Genode::size_t Component::stack_size()
+{
+	return 64*1024;
+}
+
+void Component::construct( Genode::Env &env )
+{
+	static String_test::Main main( env );
+}
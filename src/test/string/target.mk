@@ -0,0 +1,3 @@
+TARGET	= test_string
+LIBS	= libcsl base
+SRC_CC	= main.cc
@@ -0,0 +1,218 @@
+///
+/// \file       test/thread_pool/main.cc
+/// \author     Menno Valkema <menno.valkema@nlcsl.com>
+/// \date       2026-10-18
+///
+/// \copyright  Copyright (C) 2026 Cyber Security Labs B.V. The Netherlands.
+///
+/// \license    This file is part of libcsl, which is distributed
+///             under the terms of the GNU Affero General Public License version 3.
+///
+/// \brief      tests for util/thread_pool.h
+///
+
+// Genode includes
+#include <base/component.h>
+
+// CSL includes
+#include <csl/util/thread_pool.h>
+#include <csl/util/parallel.h>
+#include <csl/util/fthrow.h>
+#include <csl/util/logger.h>
+
+namespace Thread_pool_test
+{
+	struct Counting_task: Csl::Task
+	{
+		Csl::Atomic_variable<long> count;
+
+		Counting_task(): count( 0L ) {}
+
+		void execute() override
+		{
+			++count;
+		}
+	};
+
+	/// Counts the copies of the function objects alive
+	struct Tracker
+	{
+		static Csl::Atomic_variable<long> &alive()
+		{
+			static Csl::Atomic_variable<long> count( 0L );
+			return count;
+		}
+
+		Tracker() { ++alive(); }
+		Tracker( const Tracker & ) { ++alive(); }
+		~Tracker() { --alive(); }
+	};
+
+	class Main
+	{
+		private:
+			Genode::Env &_env;
+			Csl::Thread_pool _pool;
+
+		public:
+			Main( Genode::Env &env ) : _env( env ), _pool( _env )
+			{
+				ILOG( "Running on %u workers", _pool.workers() );
+
+				// Test 1: tasks submitted from outside the pool
+				Csl::Atomic_variable<long> sum( 0L );
+
+				for ( long i = 0; i < 1000; ++i )
+				{
+					_pool.submit( [&sum, i]()
+					{
+						sum.fetch_add( i );
+					} );
+				}
+
+				_pool.wait_idle();
+
+				if ( sum.load() == 999L * 1000 / 2 )
+				{ ILOG( "Test 1 succeeded" ); }
+				else
+				{ ELOG( "Test 1: sum is %ld", sum.load() ); }
+
+				// Test 2: tasks spawning tasks, which end up on the
+				// workers' own deques and get stolen
+				Csl::Atomic_variable<long> leaves( 0L );
+
+				for ( int i = 0; i < 16; ++i )
+				{
+					_pool.submit( [&]()
+					{
+						for ( int j = 0; j < 100; ++j )
+						{
+							_pool.submit( [&]() { ++leaves; } );
+						}
+					} );
+				}
+
+				_pool.wait_idle();
+
+				if ( leaves.load() == 1600 )
+				{ ILOG( "Test 2 succeeded" ); }
+				else
+				{ ELOG( "Test 2: %ld leaves executed", leaves.load() ); }
+
+				// Test 3: caller owned tasks
+				Counting_task task;
+				_pool.submit( task );
+				_pool.wait_idle();
+
+				if ( task.count.load() == 1 )
+				{ ILOG( "Test 3 succeeded" ); }
+				else
+				{ ELOG( "Test 3: task executed %ld times", task.count.load() ); }
+
+				// Test 4: a parallel_for body that throws, all chunks
+				// still run and the failure is reported
+				Csl::Atomic_variable<long> chunks( 0L );
+
+				try
+				{
+					Csl::parallel_for( _pool, 0, 64, 1, [&]( size_t b, size_t )
+					{
+						++chunks;
+
+						if ( 0 == b % 16 )
+						{
+							fthrow<Csl::Exception>( "invalid blob at %lu", b );
+						}
+					} );
+
+					ELOG( "Test 4: failure not reported" );
+				}
+				catch ( Csl::Parallel_failure &e )
+				{
+					if ( chunks.load() == 64 )
+					{ ILOG( "Test 4 succeeded: %s", e.what() ); }
+					else
+					{ ELOG( "Test 4: %ld chunks ran", chunks.load() ); }
+				}
+
+				// Test 5: tasks still queued when a pool is destroyed
+				// are discarded, in the shared queue and in the deques
+				{
+					Csl::Thread_pool pool( _env, 2 );
+					Csl::Atomic_variable<bool> go( false );
+
+					for ( int w = 0; w < 2; ++w )
+					{
+						pool.submit( [&]()
+						{
+							Tracker t;
+
+							for ( int i = 0; i < 100; ++i )
+							{
+								pool.submit( [t]() {} );
+							}
+
+							while ( not go.load() )
+							{
+								Csl::cpu_relax();
+							}
+						} );
+					}
+
+					for ( int i = 0; i < 100; ++i )
+					{
+						Tracker t;
+						pool.submit( [t]() {} );
+					}
+
+					go = true;
+				}
+
+				if ( 0 == Tracker::alive().load() )
+				{ ILOG( "Test 5 succeeded" ); }
+				else
+				{ ELOG( "Test 5: %ld tasks leaked", Tracker::alive().load() ); }
+
+				// Test 6: tasks that throw count as done, are freed, and
+				// don't stop the workers
+				{
+					Csl::Atomic_variable<long> ran( 0L );
+
+					for ( int i = 0; i < 100; ++i )
+					{
+						Tracker t;
+						_pool.submit( [&, t]()
+						{
+							++ran;
+
+							if ( 0 == ran.load() % 2 )
+							{
+								fthrow<Csl::Exception>( "task %ld failed", ran.load() );
+							}
+						} );
+					}
+
+					_pool.wait_idle();
+					_pool.submit( [&]() { ++ran; } );
+					_pool.wait_idle();
+
+					if ( 101 == ran.load() && 0 == Tracker::alive().load() )
+					{ ILOG( "Test 6 succeeded" ); }
+					else
+					{ ELOG( "Test 6: %ld tasks ran, %ld leaked", ran.load(), Tracker::alive().load() ); }
+				}
+
+				ILOG( "thread_pool test completed." );
+			}
+	};
+}
+
+Genode::size_t Component::stack_size()
+{
+	return 64*1024;
+}
+
+void Component::construct( Genode::Env &env )
+{
+	static Thread_pool_test::Main main( env );
+}
@@ -0,0 +1,3 @@
+TARGET	= test_thread_pool
+LIBS	= libcsl base
+SRC_CC	= main.cc